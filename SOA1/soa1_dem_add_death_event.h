@@ -16,34 +16,85 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
 
 /*
 GOAL: A function to add a death event. The most important part is the
-calculation of when the death is going to happen. At the moment this is still
-at a fixed age but this might be improved in the future.
+calculation of when the death is going to happen. Either at a fixed age
+(sexual_stop) or from the life table (see dem::Mortality). And functions to
+add the death from HIV when a person gets infected and the day a person
+emigrates (see dem::Migration).
+
+NOTE: The day of death is known when it is drawn, so it goes into the
+sv::DeathQueue (no event per person, dem::ev::Deaths pops the queue every
+day). A person with HIV (or who emigrates) is in the queue more than once,
+whichever comes first is the day of death (the others are skipped).
 */
 #ifndef SOA1_DEM_ADD_DEATH_EVENT_H
 #define SOA1_DEM_ADD_DEATH_EVENT_H
 
-#include <memory> // For unique_ptr to death event.
 #include "soa1_sv_state.h"
-#include "soa1_dem_ev_death.h"
+#include "soa1_sv_person.h"
+#include "soa1_sv_counter_rng.h"
 
 namespace soa1{
 namespace dem{
-void AddDeathEvent(sv::State& state, int person_id){
+inline void AddDeathEvent(sv::State& state, int person_id){
 
   // Calculate the day of death.
-  // People die at their sexual_stop defined in the parameter pack (converted
-  // to days because the model uses days).
   int day_of_birth = state.person_list()[person_id].day_of_birth();
-  int sexual_stop_days_since_birth = static_cast<int>(
-      state.parameter_pack().relation_generation_start.sexual_stop * 365
-  );
-  int day_of_death = day_of_birth + sexual_stop_days_since_birth;
-  
-  //Add the event
-  std::unique_ptr<alje::Event> event_death = 
-      std::make_unique<ev::Death>(state, person_id, day_of_death);
-  state.event_manager().Add(std::move(event_death));
+  int day_of_death;
+  if (state.mortality().enabled()) {
+    sv::CounterRng rng = state.Stream(sv::stream::MORTALITY, person_id);
+    day_of_death = state.mortality().DayOfDeath(day_of_birth, state.time(),
+        rng);
+  } else {
+    // People die at their sexual_stop defined in the parameter pack 
+    // (converted to days because the model uses days).
+    int sexual_stop_days_since_birth = static_cast<int>(
+        state.parameter_pack().relation_generation_start.sexual_stop * 365
+    );
+    day_of_death = day_of_birth + sexual_stop_days_since_birth;
+  }
+
+  // Today's deaths might have been done already (births come after deaths).
+  if (day_of_death < state.death_queue().first_day()) {
+    day_of_death = state.death_queue().first_day();
+  }
+  state.death_queue().Add(day_of_death, person_id);
 } // !function AddDeathEvent
+
+// Only if mortality is enabled, call when the person has just been infected.
+inline void AddHIVDeathEvent(sv::State& state, const sv::Person& person) {
+  if (state.mortality().enabled() == false) return;
+  sv::CounterRng rng = state.Stream(sv::stream::HIV_MORTALITY, person.id());
+  double time_until_death = state.mortality().HIVTimeUntilDeath(rng);
+  if (time_until_death == -1) return; // Never.
+
+  int day_of_death = state.time() + static_cast<int>(time_until_death);
+  if (day_of_death < state.death_queue().first_day()) {
+    day_of_death = state.death_queue().first_day();
+  }
+  state.death_queue().Add(day_of_death, person.id());
+} // !function AddHIVDeathEvent
+
+// Only if emigration is enabled, call when the person has just been added.
+// Leaving the model is the same as dying (so it is in the death queue).
+inline void AddEmigration(sv::State& state, int person_id) {
+  if (state.migration().emigration() == false) return;
+  int age = state.time() - state.person_list()[person_id].day_of_birth();
+  sv::CounterRng rng = state.Stream(sv::stream::EMIGRATION, person_id);
+  double time_until_emigration = 
+      state.migration().TimeUntilEmigration(age, rng);
+  if (time_until_emigration == -1) return; // Never.
+  // After sexual_stop the person has left anyway.
+  int sexual_stop_days_since_birth = static_cast<int>(
+      state.parameter_pack().relation_generation_start.sexual_stop * 365);
+  if (age + time_until_emigration >= sexual_stop_days_since_birth) return;
+
+  int day_of_emigration = state.time() + 
+      static_cast<int>(time_until_emigration);
+  if (day_of_emigration < state.death_queue().first_day()) {
+    day_of_emigration = state.death_queue().first_day();
+  }
+  state.death_queue().Add(day_of_emigration, person_id);
+} // !function AddEmigration
 } // !namespace dem
 } // !namespace soa1
 #endif // !SOA1_DEM_ADD_DEATH_EVENT_H
\ No newline at end of file
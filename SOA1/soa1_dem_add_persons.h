@@ -0,0 +1,136 @@
+/* SOA1, individual based STI simulation
+Copyright (C) 2015, RIVM
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+
+/*
+GOAL: Add a batch of persons (the initial population or the arrivals of a day)
+to the state, with their first relation and day of death.
+
+INPUT: The state and the day of birth of every new person.
+
+IMPLEMENTATION: 3 parts.
+  a. Construct every person (sequential, every person gets his own seeds
+     from the shared generators in a fixed order) in storage reserved for the
+     whole batch.
+  b. Find the first relation after now of every person. For old persons 
+     this means going through decades of relations, which makes this the 
+     expensive part. Every person only uses his own stationary process (and
+     the shared immutable relation start model) so this is done in 
+     parallel (for batches of at least a few hundred persons per thread,
+     in practice only the initial population).
+  c. Insert the persons and their events (sequential, in the same order).
+  Since the random numbers of a person do not depend on which thread handles
+  him, the population does not depend on the number of threads.
+
+OUTPUT: The ids of the new persons, in the order of the days of birth.
+  Person ids are unique within the program (not within a state), so they do
+  not start at 0 if another state created persons before.
+*/
+
+#ifndef SOA1_DEM_ADD_PERSONS_H
+#define SOA1_DEM_ADD_PERSONS_H
+
+#include <memory>
+#include <vector>
+#include <thread>
+
+#include "alje_event.h"
+#include "alje_event_manager.h"
+#include "soa1_sv_state.h"
+#include "soa1_sv_person.h"
+#include "soa1_dem_add_death_event.h"
+#include "soa1_rg_ev_start_relation.h"
+
+namespace soa1{
+namespace dem{ // dem -> Demographics
+
+inline std::vector<int> AddPersons(sv::State& state, 
+    const std::vector<int>& days_of_birth) {
+  int n_persons = static_cast<int>(days_of_birth.size());
+
+  // a. Construct the persons. 
+  std::vector<sv::Person> new_persons;
+  new_persons.reserve(n_persons);
+  for (int i = 0; i < n_persons; ++i){
+    new_persons.emplace_back(
+          days_of_birth[i],
+          state.relation_start_model(),
+          state.seed_generator(),
+          state.process_x_generator()
+        );
+  }
+
+  // b. Find the first relation (after now) of every person in parallel. Each
+  // thread gets a contiguous block of persons.
+  std::vector<int> t_next_relation(n_persons);
+  int now = state.time();
+  auto find_first_relations = [&new_persons, &t_next_relation, now](
+      int first, int last) {
+    for (int i = first; i < last; ++i) {
+      int t = new_persons[i].next_relation_time();
+      while (t <= now){
+        // If a person does not have any relations anymore 
+        // next_relation_time() will return an std::numeric_limits<int>::max()
+        t = new_persons[i].next_relation_time();
+      }
+      t_next_relation[i] = t;
+    }
+  };
+  int n_threads = state.parameter_pack().demographics.populate_n_threads;
+  if (n_threads <= 0) {
+    n_threads = static_cast<int>(std::thread::hardware_concurrency());
+  }
+  // Newborns and immigrants need only a few draws each, far less than 
+  // starting a thread. So every thread gets at least kMinPersonsPerThread
+  // persons, which keeps the daily arrivals sequential.
+  const int kMinPersonsPerThread = 500;
+  if (n_threads > n_persons / kMinPersonsPerThread) {
+    n_threads = n_persons / kMinPersonsPerThread;
+  }
+  if (n_threads <= 1) {
+    find_first_relations(0, n_persons);
+  } else {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < n_threads; ++t) {
+      threads.emplace_back(find_first_relations, 
+          static_cast<int>(static_cast<long long>(n_persons) * t / n_threads),
+          static_cast<int>(
+            static_cast<long long>(n_persons) * (t + 1) / n_threads));
+    }
+    for (std::thread& thread : threads) thread.join();
+  }
+
+  // c. Insert the persons and their events. Note that since a Person cannot 
+  // be copy-constructed we use std::move in order to invoke the move 
+  // constructor.
+  std::vector<int> person_ids(n_persons);
+  for (int i = 0; i < n_persons; ++i){
+    int person_id = new_persons[i].id();
+    person_ids[i] = person_id;
+    state.person_list().Insert(std::move(new_persons[i]));
+    state.age_cohort_index().Add(state.person_list()[person_id]);
+    AddDeathEvent(state, person_id);
+    AddEmigration(state, person_id);
+
+    std::unique_ptr<alje::Event> first_relation = 
+        std::make_unique<soa1::rg::ev::StartRelation>(
+        state, person_id, t_next_relation[i]);
+    state.event_manager().Add(std::move(first_relation));
+  }
+  return person_ids;
+} // !function AddPersons
+} // !namespace dem
+} // !namespace soa1
+#endif // !SOA1_DEM_ADD_PERSONS_H
@@ -0,0 +1,90 @@
+/* SOA1, individual based STI simulation
+Copyright (C) 2015, RIVM
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+
+/*
+GOAL: Draw from a discrete distribution in constant time, whatever the number
+of outcomes (see dem::Mortality).
+
+INPUT: Two unit uniform random numbers per draw.
+
+INPUT ON CONSTRUCTION: The weights of the outcomes (need not sum to 1).
+
+IMPLEMENTATION: The alias method (Vose 1991). Every outcome i gets a column
+of height 1 holding a part prob_[i] of itself and the rest of outcome
+alias_[i]. A draw picks a column with the first number and the part with the
+second.
+
+OUTPUT: The index of the outcome.
+*/
+
+#ifndef SOA1_DEM_ALIAS_TABLE_H
+#define SOA1_DEM_ALIAS_TABLE_H
+#include <vector>
+#include <cassert>
+
+namespace soa1 {
+namespace dem { // dem -> demographics
+
+class AliasTable {
+public:
+  inline int Draw(double u_column, double u_part) const {
+    int column = static_cast<int>(u_column * prob_.size());
+    if (column == static_cast<int>(prob_.size())) --column; // u_column == 1
+    return u_part < prob_[column] ? column : alias_[column];
+  }
+
+  int size() const {return static_cast<int>(prob_.size());}
+
+  AliasTable(const std::vector<double>& weights) :
+      prob_(weights.size(), 1.0),
+      alias_(weights.size()) {
+    assert(weights.empty() == false && "Error in soa1::dem::AliasTable, no "
+      "outcomes.");
+    double total = 0;
+    for (double w : weights) total += w;
+    assert(total > 0 && "Error in soa1::dem::AliasTable, all weights are 0.");
+
+    int n = static_cast<int>(weights.size());
+    std::vector<double> scaled(n);
+    std::vector<int> small;
+    std::vector<int> large;
+    for (int i = 0; i < n; ++i) {
+      alias_[i] = i;
+      scaled[i] = weights[i] * n / total;
+      if (scaled[i] < 1) small.push_back(i); else large.push_back(i);
+    }
+    while (small.empty() == false && large.empty() == false) {
+      int s = small.back();
+      small.pop_back();
+      int l = large.back();
+      prob_[s] = scaled[s];
+      alias_[s] = l;
+      scaled[l] -= 1 - scaled[s];
+      if (scaled[l] < 1) {
+        large.pop_back();
+        small.push_back(l);
+      }
+    }
+    // What is left is 1 up to rounding errors, prob_ is already 1.
+  }
+
+private:
+  std::vector<double> prob_; // Part of column i which is outcome i.
+  std::vector<int> alias_;   // The outcome of the rest of column i.
+};//!class AliasTable
+}// !namespace dem
+}// !namespace soa1
+#endif// !SOA1_DEM_ALIAS_TABLE_H
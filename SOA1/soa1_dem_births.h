@@ -15,16 +15,24 @@ You should have received a copy of the GNU General Public License
 along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
 
 /* 
-GOAL: This function will calculate the number of births required AND update
-the person_list with the new births.
+GOAL: This function will calculate the number of births (and immigrants) of
+today AND update the person_list with the new arrivals.
 
 IMPLEMENTATION: 
 * The person list will only contain the sexually active
   population. So when someone gets 'born' into the population list they are
   15 years old (or whatever the sexual onset is). 
-* At the moment this algorithm uses a non-stochastic (=deterministic)
-  population size. This is done in order to avoid unpredictable behavior
-  (sudden huge increases in population might make analysing the results harder)
+* The target population size is initial_population, growing by
+  annual_growth_rate a year.
+* By default this algorithm uses a non-stochastic (=deterministic)
+  population size: the shortage is refilled with births. This is done in
+  order to avoid unpredictable behavior (sudden huge increases in population
+  might make analysing the results harder). With stochastic_births the number
+  of births is Poisson distributed with the shortage as mean.
+* Immigrants arrive as a Poisson process with ages from the immigration age
+  groups (see dem::Migration).
+* All arrivals of a day are added in one batch (see dem::AddPersons): births
+  first, then immigrants.
 
 INPUT: The system state (parameter pack and current population are used for
 sure, other things might)
@@ -36,51 +44,57 @@ OUTPUT: void (it updates the person list in the state)
 #define SOA1_DEM_BIRTHS_H
 
 #include <cmath>
+#include <random>
+#include <vector>
 
 #include "soa1_sv_state.h"
-#include "soa1_sv_person.h"
-#include "soa1_dem_add_death_event.h"
-#include "soa1_rg_ev_start_relation.h"
+#include "soa1_sv_counter_rng.h"
+#include "soa1_dem_add_persons.h"
 
 namespace soa1{
 namespace dem{
 
+// The population size births refill to today.
+inline double TargetPopulation(sv::State& state) {
+  const parameters::Demographics& par = state.parameter_pack().demographics;
+  if (par.annual_growth_rate == 0) return par.initial_population;
+  return par.initial_population * 
+      std::pow(1 + par.annual_growth_rate, state.time() / 365.0);
+}
+
 // Birth is starting to be sexual active
 void Births(sv::State& state){
-  int current_population = state.person_list().Size();
-  int current_required_population = 
-    state.parameter_pack().demographics.initial_population;
-  int required_n_births = current_required_population - current_population;
-
-  for (int i = 0; i < required_n_births; ++i){
-    int day_of_birth = state.time() - 
-        static_cast<int>(
-        state.parameter_pack().relation_generation_start.sexual_onset * 365);
-
-    sv::Person person_to_insert(
-      day_of_birth,
-      state.parameter_pack(),
-      state.seed_generator(),
-      state.process_x_generator()
-    );
-
-    int person_id = person_to_insert.id();
-
-    // Both times in the line below refer to system time as stored in state (not
-    // person time).
-    int t_first_relation = person_to_insert.next_relation_time();
-    state.person_list().Insert(std::move(person_to_insert));
-    soa1::dem::AddDeathEvent(state, person_id);
-    
-    std::unique_ptr<alje::Event> first_relation = 
-      std::make_unique<rg::ev::StartRelation>(state,person_id,t_first_relation);
-    state.event_manager().Add(std::move(first_relation));
-
-
+  const parameters::Demographics& par = state.parameter_pack().demographics;
+  double shortage = TargetPopulation(state) - state.person_list().Size();
+
+  int n_births = 0;
+  if (par.stochastic_births == false) {
+    n_births = static_cast<int>(std::floor(shortage + 0.5));
+  } else if (shortage > 0) {
+    sv::CounterRng rng = state.Stream(sv::stream::BIRTHS, state.time());
+    std::poisson_distribution<int> births(shortage);
+    n_births = births(rng);
   }
-
+  if (n_births < 0) n_births = 0;
+
+  sv::CounterRng immigration_rng = 
+      state.Stream(sv::stream::IMMIGRATION, state.time());
+  int n_immigrants = state.migration().NImmigrants(immigration_rng);
+  if (n_births + n_immigrants == 0) return;
+
+  std::vector<int> days_of_birth;
+  days_of_birth.reserve(n_births + n_immigrants);
+  int day_of_birth = state.time() - 
+      static_cast<int>(
+      state.parameter_pack().relation_generation_start.sexual_onset * 365);
+  days_of_birth.assign(n_births, day_of_birth);
+  for (int i = 0; i < n_immigrants; ++i) {
+    days_of_birth.push_back(state.time() - 
+        state.migration().ImmigrantAge(immigration_rng));
+  }
+  AddPersons(state, days_of_birth);
 }// !function Births
 
 }// !namespace soa1
 }// !namespace dem
-#endif// !SOA1_DEM_BIRTHS_H
\ No newline at end of file
+#endif// !SOA1_DEM_BIRTHS_H
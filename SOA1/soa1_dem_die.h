@@ -0,0 +1,63 @@
+/* SOA1, individual based STI simulation
+Copyright (C) 2015, RIVM
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+
+/*
+GOAL: Everything which happens when a person dies, for every cause of death
+(see dem::ev::Deaths and dem::ev::Death).
+
+INPUT: The state and the person who dies.
+
+IMPLEMENTATION:
+1. Let everyone interested know this person is dying (in step 3).
+2. For every relation of this person, notify all interested events that this
+   relation ends.
+3. Remove the person from the person_list (and the sv::AgeCohortIndex).
+   This is done as step 3 (and not 1 or 2) so that events notified in step 1
+   or 2 can still use access this person and exit cleanly.
+
+OUTPUT: void (one person less)
+*/
+
+#ifndef SOA1_DEM_DIE_H
+#define SOA1_DEM_DIE_H
+
+#include <vector>
+#include "soa1_sv_state.h"
+#include "soa1_sv_person_event_codes.h"
+#include "soa1_sv_relation_event_codes.h"
+
+namespace soa1{
+namespace dem{
+inline void Die(sv::State& state, int person_id) {
+  // 1.
+  state.event_manager().NotifyChannel1(person_id, 
+                                       sv::person_event_codes::DEATH);
+
+  // 2.
+  std::vector<int> all_relations =
+    state.relation_list().FindRelationIDsGivenPersonID(person_id);
+  for (int relation_id : all_relations){
+    state.event_manager().NotifyChannel2(relation_id,
+        sv::relation_event_codes::END_DUE_TO_DEATH);
+  }
+
+  // 3.
+  state.age_cohort_index().Remove(state.person_list()[person_id]);
+  state.person_list().Erase(person_id);
+} // !function Die
+} // !namespace dem
+} // !namespace soa1
+#endif // !SOA1_DEM_DIE_H
@@ -30,6 +30,7 @@ namespace ev {   // ev -> event
 class Births : public alje::Event {
 public:
   virtual void Execute() override {
+    ++state_.n_events_executed();
 
     dem::Births(state_);
 
@@ -0,0 +1,74 @@
+/* SOA1, individual based STI simulation
+Copyright (C) 2015, RIVM
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+
+/*
+GOAL: Every day, let the persons die whose day of death has come (see
+sv::DeathQueue).
+
+IMPLEMENTATION: As dem::ev::Births, one event which adds the event of the
+next day. Persons who are not in the person list anymore (died in another
+way) are skipped.
+*/
+#ifndef SOA1_DEM_EV_DEATHS_H
+#define SOA1_DEM_EV_DEATHS_H
+#include <cassert>
+#include <memory> // For unique_ptr to the next Deaths event.
+#include <vector>
+#include "alje_event.h"
+#include "soa1_sv_priority_list.h"
+#include "soa1_sv_state.h"
+#include "soa1_dem_die.h"
+
+namespace soa1 { // SOA is the dutch equivalent of STI
+namespace dem {  // dem -> demographics
+namespace ev {   // ev -> event
+
+class Deaths : public alje::Event {
+public:
+  virtual void Execute() override {
+    ++state_.n_events_executed();
+    std::vector<int> dying = state_.death_queue().PopDue(time_due_);
+    for (int person_id : dying) {
+      if (state_.person_list().Contains(person_id)) {
+        dem::Die(state_, person_id);
+      }
+    }
+
+    // Schedule the next Deaths event
+    std::unique_ptr<Event> next_event =
+      std::make_unique<ev::Deaths>(state_, time_due_ + 1);
+    state_.event_manager().Add(std::move(next_event));
+  }
+
+  virtual bool Notify(int track, int number, int extra_info) override {
+    assert("ev_Deaths->Notify should not be called (but it is!).");
+    return false;
+  }
+
+  Deaths(sv::State& state, int time_due) : 
+    Event(time_due, sv::priority::DEATH, -1, -1),
+    state_(state),
+    time_due_(time_due) {
+  }
+
+private:
+  sv::State& state_;
+  int time_due_;
+};//!class Deaths
+}// !namespace ev
+}// !namespace dem
+}// !namespace soa1
+#endif// !SOA1_DEM_EV_DEATHS_H
@@ -0,0 +1,138 @@
+/* SOA1, individual based STI simulation
+Copyright (C) 2015, RIVM
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+
+/*
+GOAL: Draw the immigrants of a day (how many and their ages) and the day a
+person emigrates. See parameters::Demographics.
+
+INPUT: A random number generator, and for emigration the age of the person.
+
+INPUT ON CONSTRUCTION: The demographics parameters and the ages (in days) at
+which persons enter (sexual_onset) and leave (sexual_stop) the model.
+
+IMPLEMENTATION: The number of immigrants of a day is Poisson distributed. The
+age group of an immigrant comes from an alias table (dem::AliasTable) of the
+weights, the age within the group is uniform. Emigration is a competing risk
+as HIV mortality (see dem::Mortality): it is drawn once from the cumulative
+hazard of the rate over age (tr::CumulativeHazard).
+
+OUTPUT: The number of immigrants, the age of an immigrant (in days) and the
+days until emigration (-1 for never).
+
+NOTE: An emigrant simply leaves the model, which for the model is the same as
+dying (see dem::AddEmigration).
+*/
+
+#ifndef SOA1_DEM_MIGRATION_H
+#define SOA1_DEM_MIGRATION_H
+#include <vector>
+#include <random>
+#include <cassert>
+#include "soa1_parameters_pack.h"
+#include "soa1_dem_alias_table.h"
+#include "soa1_tr_layer.h"
+#include "soa1_tr_cumulative_hazard.h"
+
+namespace soa1 {
+namespace dem { // dem -> demographics
+
+class Migration {
+public:
+  bool immigration() const {return daily_immigration_ > 0;}
+  bool emigration() const {return emigration_;}
+
+  template <typename Rng>
+  int NImmigrants(Rng& rng) const {
+    if (immigration() == false) return 0;
+    std::poisson_distribution<int> n_immigrants(daily_immigration_);
+    return n_immigrants(rng);
+  }
+
+  template <typename Rng>
+  int ImmigrantAge(Rng& rng) const {
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    double u_column = unit(rng);
+    int group = age_group_.Draw(u_column, unit(rng));
+    std::uniform_int_distribution<int> age(group_start_[group], 
+        group_start_[group + 1] - 1);
+    return age(rng);
+  }
+
+  template <typename Rng>
+  double TimeUntilEmigration(int age, Rng& rng) const {
+    std::exponential_distribution<double> unit_exponential(1.0);
+    return emigration_hazard_.TimeUntil(age, unit_exponential(rng));
+  }
+
+  Migration(const parameters::Demographics& parameters, 
+      int sexual_onset_days, int sexual_stop_days) :
+      daily_immigration_(parameters.annual_immigration / kDaysPerYear),
+      age_group_(AgeGroupWeights(parameters)),
+      emigration_(false),
+      emigration_hazard_(EmigrationLayer(parameters)) {
+    const std::vector<std::vector<double>>& groups =
+        parameters.immigration_weight_given_age;
+    for (const std::vector<double>& group : groups) {
+      group_start_.push_back(static_cast<int>(group[0] * kDaysPerYear));
+    }
+    group_start_.push_back(sexual_stop_days);
+    assert(group_start_[0] >= sexual_onset_days && "Error in soa1::dem::"
+      "Migration, immigrants should be at least sexual_onset years old.");
+    for (int i = 0; i + 1 < static_cast<int>(group_start_.size()); ++i) {
+      assert(group_start_[i] < group_start_[i + 1] && "Error in soa1::dem::"
+        "Migration, the immigration age groups should be ascending and "
+        "below sexual_stop.");
+    }
+
+    for (const std::vector<double>& period : 
+        parameters.emigration_rate_given_age) {
+      assert(period[1] >= 0 && "Error in soa1::dem::Migration, a negative "
+        "emigration rate.");
+      if (period[1] > 0) emigration_ = true;
+    }
+  }
+
+private:
+  static const int kDaysPerYear = 365;
+  double daily_immigration_;   // Mean number of immigrants a day.
+  AliasTable age_group_;       // Age group of an immigrant.
+  std::vector<int> group_start_; // In days since birth, the last is the end.
+  bool emigration_;            // false if every rate is 0 (skip the draws).
+  tr::CumulativeHazard emigration_hazard_; // Per day of age.
+
+  static std::vector<double> AgeGroupWeights(
+      const parameters::Demographics& parameters) {
+    std::vector<double> weights;
+    for (const std::vector<double>& group : 
+        parameters.immigration_weight_given_age) {
+      weights.push_back(group[1]);
+    }
+    return weights;
+  }
+
+  static tr::Layer EmigrationLayer(
+      const parameters::Demographics& parameters) {
+    tr::Layer layer;
+    for (const std::vector<double>& period : 
+        parameters.emigration_rate_given_age) {
+      layer.push_back({period[0] * kDaysPerYear, period[1] / kDaysPerYear});
+    }
+    return layer;
+  }
+};//!class Migration
+}// !namespace dem
+}// !namespace soa1
+#endif// !SOA1_DEM_MIGRATION_H
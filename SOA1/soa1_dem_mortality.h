@@ -0,0 +1,164 @@
+/* SOA1, individual based STI simulation
+Copyright (C) 2015, RIVM
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+
+/*
+GOAL: Draw the day of death of a person from a life table (and the time from
+infection until death from HIV), in constant time, so births do not get
+slower. See parameters::Mortality.
+
+INPUT: The day of birth and today (the person is alive today) or, for HIV, a
+person who has just been infected. And a random number generator.
+
+INPUT ON CONSTRUCTION: The mortality parameters and the age (in days) at which
+everybody leaves the model (sexual_stop).
+
+IMPLEMENTATION: The hazard is constant within every year of age (from the
+table). On construction an alias table (dem::AliasTable) is made for every
+year of age with the year of death of someone alive at the start of that
+year, the last outcome being reaching sexual_stop. A draw is:
+1. Does the person die in what is left of the current year? (exponential)
+2. If not, the year of death from the alias table of the next year.
+3. The day within that year (exponential, truncated at the end of the year).
+HIV deaths come from the cumulative hazard of the excess mortality over time
+since infection (tr::CumulativeHazard), a competing risk which only needs to
+be drawn once as the stages follow from the time since infection.
+
+OUTPUT: A day of death (at sexual_stop at the latest), or the days from
+infection until death from HIV (-1 for never).
+*/
+
+#ifndef SOA1_DEM_MORTALITY_H
+#define SOA1_DEM_MORTALITY_H
+#include <vector>
+#include <cmath>
+#include <random>
+#include <cassert>
+#include <algorithm> // For min
+#include "soa1_parameters_pack.h"
+#include "soa1_dem_alias_table.h"
+#include "soa1_tr_layer.h"
+#include "soa1_tr_cumulative_hazard.h"
+
+namespace soa1 {
+namespace dem { // dem -> demographics
+
+class Mortality {
+public:
+  bool enabled() const {return enabled_;}
+
+  template <typename Rng>
+  int DayOfDeath(int day_of_birth, int today, Rng& rng) const {
+    int age = today - day_of_birth;
+    if (age >= stop_days_) return day_of_birth + stop_days_;
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    // 1. The rest of this year.
+    int year = age / kDaysPerYear;
+    int year_end = std::min((year + 1) * kDaysPerYear, stop_days_);
+    double hazard = daily_hazard_[year];
+    if (hazard > 0) {
+      double t = -std::log(1 - unit(rng)) / hazard;
+      if (t < year_end - age) return day_of_birth + age + static_cast<int>(t);
+    }
+    if (year + 1 >= n_years()) return day_of_birth + stop_days_;
+
+    // 2. The year of death (the outcomes start at year + 1).
+    double u_column = unit(rng);
+    int death_year = year + 1 + 
+        year_of_death_[year + 1].Draw(u_column, unit(rng));
+    if (death_year == n_years()) return day_of_birth + stop_days_;
+
+    // 3. The day within that year.
+    hazard = daily_hazard_[death_year];
+    int length = YearLength(death_year);
+    double t = -std::log(1 - unit(rng) * (1 - std::exp(-hazard * length))) /
+        hazard;
+    int day = std::min(static_cast<int>(t), length - 1);
+    return day_of_birth + death_year * kDaysPerYear + day;
+  }
+
+  template <typename Rng>
+  double HIVTimeUntilDeath(Rng& rng) const {
+    std::exponential_distribution<double> unit_exponential(1.0);
+    return hiv_hazard_.TimeUntil(0, unit_exponential(rng));
+  }
+
+  Mortality(const parameters::Mortality& parameters, int sexual_stop_days) :
+      enabled_(parameters.enabled),
+      stop_days_(sexual_stop_days),
+      hiv_hazard_(HIVLayer(parameters)) {
+    const std::vector<std::vector<double>>& table = 
+        parameters.annual_probability_given_age;
+    assert(table.empty() == false && table[0][0] == 0 && "Error in "
+      "soa1::dem::Mortality, the life table should start at age 0.");
+
+    // The hazard per year of age.
+    int row = 0;
+    for (int year = 0; year * kDaysPerYear < stop_days_; ++year) {
+      while (row + 1 < static_cast<int>(table.size()) && 
+          table[row + 1][0] <= year) {
+        ++row;
+      }
+      double probability = table[row][1];
+      assert(probability >= 0 && probability < 1 && "Error in soa1::dem::"
+        "Mortality, an annual probability of dying should be in [0, 1).");
+      daily_hazard_.push_back(-std::log(1 - probability) / kDaysPerYear);
+    }
+
+    // The year of death of someone alive at the start of every year.
+    for (int from = 0; from < n_years(); ++from) {
+      std::vector<double> weights;
+      double survival = 1;
+      for (int year = from; year < n_years(); ++year) {
+        double survive_year = std::exp(-daily_hazard_[year] * YearLength(year));
+        weights.push_back(survival * (1 - survive_year));
+        survival *= survive_year;
+      }
+      weights.push_back(survival); // Reaches sexual_stop.
+      year_of_death_.emplace_back(weights);
+    }
+  }
+
+private:
+  static const int kDaysPerYear = 365;
+  bool enabled_;
+  int stop_days_;
+  std::vector<double> daily_hazard_;     // Per year of age.
+  // Per year of age alive at the start (from), outcome i is dying in year
+  // from + i, the last outcome is reaching sexual_stop.
+  std::vector<AliasTable> year_of_death_;
+  tr::CumulativeHazard hiv_hazard_;      // Per day since infection.
+
+  int n_years() const {return static_cast<int>(daily_hazard_.size());}
+
+  // The last year stops at sexual_stop.
+  int YearLength(int year) const {
+    int rest = stop_days_ - year * kDaysPerYear;
+    return rest < kDaysPerYear ? rest : kDaysPerYear;
+  }
+
+  static tr::Layer HIVLayer(const parameters::Mortality& parameters) {
+    tr::Layer layer;
+    for (const std::vector<double>& period : 
+        parameters.hiv_excess_rate_over_time) {
+      layer.push_back({period[0], period[1] / kDaysPerYear});
+    }
+    return layer;
+  }
+};//!class Mortality
+}// !namespace dem
+}// !namespace soa1
+#endif// !SOA1_DEM_MORTALITY_H
@@ -21,8 +21,12 @@ IMPLEMENTATION: A function consisting of 3 parts.
   1. Some checks
   2. Initializing random variable genarators for age and such based on 
      the parameter pack
-  3. Generate the (homogenous) population
+  3. Generate the (homogenous) population: draw the ages and add the persons
+     in one batch (see dem::AddPersons).
 
+OUTPUT: The ids of the new persons, in the order in which they were created.
+  Person ids are unique within the program (not within a state), so they do
+  not start at 0 if another state created persons before.
 */
 
 #ifndef SOA1_DEM_POPULATE_H
@@ -30,20 +34,16 @@ IMPLEMENTATION: A function consisting of 3 parts.
 
 #include <assert.h>
 #include <random>
-#include <memory>
+#include <vector>
 
-#include "alje_event.h"
-#include "alje_event_manager.h"
 #include "soa1_sv_state.h"
-#include "soa1_sv_person.h"
-#include "soa1_dem_add_death_event.h"
-#include "soa1_rg_ev_start_relation.h"
+#include "soa1_dem_add_persons.h"
 
 namespace soa1{
 namespace dem{ // dem -> Demographics
 
 //When initializing demographics we initialize the person list.
-void Populate(sv::State& state) {
+std::vector<int> Populate(sv::State& state) {
 
   // First check if the person_list is empty
   assert(state.person_list().Size() == 0 && "Error in Births. Trying to "
@@ -57,38 +57,15 @@ void Populate(sv::State& state) {
   int sexual_stop = static_cast<int>(
     state.parameter_pack().relation_generation_start.sexual_stop * 365);
   int n_persons = state.parameter_pack().demographics.initial_population;
-  std::default_random_engine rng(state.seed_generator().Get());
+  sv::CounterRng rng = state.Stream(sv::stream::POPULATE);
   std::uniform_int_distribution<>random_age(sexual_onset,sexual_stop);
     
   // Start with a homogenous population
-  std::unique_ptr<sv::Person> uptr_person;
+  std::vector<int> days_of_birth(n_persons);
   for (int i = 0; i < n_persons; ++i){
-    // Insert the person into the list. Note that since a Person cannot be 
-    // copy-constructed we use a temporary/rvalue in order to invoke the 
-    // move constructor.
-    sv::Person person_to_insert(
-          -random_age(rng),
-          state.parameter_pack(),
-          state.seed_generator(),
-          state.process_x_generator()
-        );
-    int person_id = person_to_insert.id();
-    int t_next_relation = person_to_insert.next_relation_time();
-
-    while (t_next_relation <= state.time()){
-      // If a person does not have any relations anymore next_relation_time()
-      // will return an std::numeric_limits<int>::max().
-      t_next_relation = person_to_insert.next_relation_time();
-    }
-    
-    state.person_list().Insert(std::move(person_to_insert));
-    AddDeathEvent(state, person_id);
-
-    std::unique_ptr<alje::Event> first_relation = 
-        std::make_unique<soa1::rg::ev::StartRelation>(
-        state, person_id, t_next_relation);
-    state.event_manager().Add(std::move(first_relation));
+    days_of_birth[i] = -random_age(rng);
   }
+  return AddPersons(state, days_of_birth);
 } // !function InitialBirths
 } // !namespace dem
 } // !namespace soa1
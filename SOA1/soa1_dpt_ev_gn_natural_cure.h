@@ -36,6 +36,7 @@ namespace ev {   // ev -> event
 class GNNaturalCure : public alje::Event {
 public:
   virtual void Execute() override{
+    ++state_.n_events_executed();
     assert(state_.person_list()[person_id_].gonorrhea_status().infected()
       == true && "Error we are trying to cure someone from Gonorrhea who does"
       "not have Gonorrhea");
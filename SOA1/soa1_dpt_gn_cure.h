@@ -31,12 +31,7 @@ OUTPUT: NA (updates the state variable)
 #include "alje_event.h"
 #include "soa1_sv_state.h"
 #include "soa1_sv_person_event_codes.h"
-#include "soa1_tr_update_gn_transmission_event.h"
-
-// Forward declarations to avoid circular inclusion loop
-namespace soa1 {namespace tr {// tr -> transmission
-void UpdateGNTransmissionEvent(soa1::sv::State&, const soa1::sv::Relation&);
-}}
+#include "soa1_sv_transmission_update_list.h"
 
 namespace soa1 { // soa is the dutch equivalent of sti
 namespace dpt {  // dpt -> disease progression and treatment
@@ -53,12 +48,13 @@ void Cure(sv::State& state, int person_id) {
       sv::person_event_codes::GN_CURED);
 
   // Update Gonorrhea transmission, also update HIV transmission because
-  // having Gonorrhea increases the probability of HIV transmission.
+  // having Gonorrhea increases the probability of HIV transmission. Done at
+  // the end of the priority (see sv::TransmissionUpdateList).
   std::vector<const sv::Relation*>& all_relations = 
       state.relation_list().FindRelationsGivenPersonID(person_id);
   for (const sv::Relation* relation_ptr : all_relations) {
-    tr::UpdateGNTransmissionEvent(state, *relation_ptr);
-    tr::UpdateHIVTransmissionEvent(state, *relation_ptr);
+    state.transmission_update_list().Add(relation_ptr->relation_id(),
+        sv::transmission_update::ALL);
   }
 };//!function cure
 }// !namespace dpt
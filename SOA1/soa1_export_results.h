@@ -30,24 +30,21 @@ std::string ExportResults(sv::State& state){
   std::vector<const sv::Person*> all_persons_ptr_vec 
       = state.person_list().GetAll();
 
-  int n_hiv_positive = 0;
+  // HIV and ages come from the age cohort index (HIV is never cured).
+  sv::AgeCohortIndex::Band everyone = 
+      state.age_cohort_index().All(state.time());
+  int n_hiv_positive = everyone.n_hiv;
   int n_gn_positive = 0;
-  long long total_age_hiv_positive = 0;
-  long long total_age = 0;
+  long long total_age_hiv_positive = everyone.total_age_hiv;
+  long long total_age = everyone.total_age;
   std::vector<int> n_partners_hist;
   n_partners_hist.resize(5000);
   
   for (const sv::Person* person_ptr : all_persons_ptr_vec) {
-    if (person_ptr->hiv_status().infected() == true) {
-      ++n_hiv_positive;
-      total_age_hiv_positive += (state.time() - person_ptr->day_of_birth());
-    }
-
     if (person_ptr->gonorrhea_status().infected() == true) {
       ++n_gn_positive;
     }
 
-    total_age += (state.time() - person_ptr->day_of_birth());
     int n_partners = state.relation_list().FindRelationsGivenPersonID(
         person_ptr->id()).size();
     ++n_partners_hist[n_partners];
@@ -68,7 +65,24 @@ std::string ExportResults(sv::State& state){
       100* n_gn_positive / static_cast<double>(all_persons_ptr_vec.size())
     ) + "%) \nAverage age (years) (hivpos/overall): " 
     + std::to_string(average_age_hiv_pos) + "/" + std::to_string(average_age)
-    + "\n\n";
+    + "\nN_short_relations (not stored): " 
+    + std::to_string(state.n_short_relations()) + "\n";
+
+  // HIV prevalence per 10 years of age (see sv::AgeCohortIndex).
+  return_string += "HIV prevalence given age (years):";
+  int sexual_onset = static_cast<int>(
+      state.parameter_pack().relation_generation_start.sexual_onset);
+  int sexual_stop = static_cast<int>(
+      state.parameter_pack().relation_generation_start.sexual_stop);
+  for (int age = sexual_onset; age < sexual_stop; age += 10) {
+    int band_end = age + 10 < sexual_stop ? age + 10 : sexual_stop;
+    sv::AgeCohortIndex::Band band = state.age_cohort_index().InAgeBand(
+        state.time(), age * 365, band_end * 365);
+    return_string += " " + std::to_string(age) + "-" + 
+      std::to_string(band_end) + ": " + std::to_string(band.n_hiv) + "/" +
+      std::to_string(band.n);
+  }
+  return_string += "\n\n";
 
   //std::ofstream n_partners_out("n_partners_hist.txt");
   for (int i = 0; i < 10; ++i) {
@@ -35,19 +35,73 @@ of days for accuracy, the paramter pack is in years for easy readibility)
 #define SOA1_PARAMETERS_PACK_H
 
 #include <string>
+#include <vector>
 
 namespace soa1 {
 namespace parameters {
 
 struct Demographics{
   int initial_population = 23800; // XXX 238.000 Sexually active population
+  // Threads used to add persons (the initial population and arrivals, see
+  // dem::AddPersons). 0 means one per core. The population does not depend on
+  // this.
+  int populate_n_threads = 0;
+  // false: every day the population is refilled to exactly the target size.
+  // true: the number of births of a day is Poisson distributed with the
+  // shortage as mean.
+  bool stochastic_births = false;
+  // The target size grows by this fraction a year (initial_population at
+  // t = 0).
+  double annual_growth_rate = 0;
+  // Immigrants a year (a Poisson number every day) and their ages: {age in
+  // years, weight} from that age until the age of the next row (the last row
+  // until sexual_stop). Ages should be in [sexual_onset, sexual_stop).
+  double annual_immigration = 0;
+  std::vector<std::vector<double>> immigration_weight_given_age = {
+    {15, 1},
+    {25, 1},
+    {35, 0.5},
+    {45, 0.2}
+  };
+  // {age in years, emigrants per person per year} from that age until the
+  // age of the next row (as annual_probability_given_age).
+  std::vector<std::vector<double>> emigration_rate_given_age = {
+    {0, 0}
+  };
+};
+
+struct Mortality {
+  // false: everybody dies at sexual_stop. true: persons die according to the
+  // life table (and of HIV), but at sexual_stop at the latest.
+  bool enabled = false;
+  // {age in years, probability of dying within a year} from that age until
+  // the age of the next row.
+  std::vector<std::vector<double>> annual_probability_given_age = {
+    {0, 0.0002},
+    {25, 0.0004},
+    {35, 0.0007},
+    {45, 0.0017},
+    {55, 0.0045},
+    {65, 0.011},
+    {75, 0.03}
+  };
+  // Extra mortality of HIV {days since infection, deaths per year} from that
+  // time until the time of the next row (as infectivity_over_time).
+  std::vector<std::vector<double>> hiv_excess_rate_over_time = {
+    {0, 0.005},
+    {400, 0.01},
+    {3650, 0.15}
+  };
 };
 
 struct RelationGenerationStart{
 
   // RG Start Stationary process
   double stat_process_average = 16;
-  int stat_process_n_prearrivals = 1000000; // XXX #arrivals per person for initialization
+  // #arrivals for initialization of the stationary process. 0 means derive
+  // it from the decay rates (see rg::start::RelationStartModel). To pay for
+  // the warm-up only once, see Output::process_x_cache_file_prefix.
+  int stat_process_n_prearrivals = 1000000;
   double weight_average = 0.5;          
   double weight_short_history = 0.5; 
   double weight_long_history = 0; 
@@ -76,10 +130,24 @@ struct RelationGenerationStart{
 };
 
 struct RelationDuration {
-  std::string distribution = "gamma"; 
+  std::string distribution = "gamma"; // or "lognormal" or "weibull"
   double mean = 20; // in DAYS
   double variance = 40; // in DAYS^2 
   double monogamy = 0.5; //1 equals fully monogamous, 0 equals fully concurrent
+  // Durations come from a table of the quantile function. This is the largest
+  // error allowed in this table.
+  double quantile_table_max_error = 0.01; // in DAYS
+  // The interrelation time distribution is learned from the interrelation
+  // times seen so far (see rg_dur_values_to_percentiles).
+  int percentile_max_samples = 100000; // 0 means no maximum
+  // Weight of an interrelation time halves after this many new ones. Allows
+  // following a changing distribution. 0 means no forgetting.
+  double percentile_forgetting_half_life = 0; // In number of samples (not years)
+  // Relations of at most this duration are not stored, their transmissions
+  // are decided at the start (see rg::AddRelation). Changes to a partner's
+  // status during such a relation are not seen, and it doesn't count towards
+  // the partner histogram of ExportResults. -1 stores all relations.
+  int short_relation_max_duration = -1; // in DAYS
 };
 
 struct MatchMaking {
@@ -147,6 +215,7 @@ struct TransmissionHIV {
   //If a person has gonorrhea, how much more infective is he?
   double hiv_pos_has_gonorrhea_multiplier = 1.5; 
   double hiv_neg_has_gonorrhea_multiplier = 1.5;
+  int initial_n_infected = 500; // Infected at the start of the simulation.
 };
 
 struct TransmissionGonorrhea {
@@ -154,16 +223,35 @@ struct TransmissionGonorrhea {
   double probability_symptomatic = 0.6;
   int natural_cure_symptomatic = 45;
   int natural_cure_asymptomatic = 200; 
+  int initial_n_infected = 500; // Infected at the start of the simulation.
+};
+
+struct TransmissionEvents {
+  // false: one transmission event per STI per relation (see
+  // tr::ev::StiTransmission). true: one event per relation for all STIs (see
+  // tr::ev::RelationTransmission), executed at priority STI_TRANSMISSION.
+  bool one_event_per_relation = false;
+};
+
+struct Output {
+  // Who infected whom (see sv::TransmissionTreeLog). Empty -> not recorded.
+  std::string transmission_tree_file = "";
+  // Warmed alje::ProcessXGenerators (see rg::start::ProcessXCache) are stored
+  // as <prefix><hash>.bin, e.g. "cache/process_x_". Empty -> no cache.
+  std::string process_x_cache_file_prefix = "";
 };
 
 struct ParameterPack{
   Demographics demographics;
+  Mortality mortality;
   RelationGenerationStart relation_generation_start;
   RelationDuration relation_generation_duration;
   MatchMaking matchmaking;
   TransmissionSexualBehavior sexual_behavior;
   TransmissionHIV hiv;
   TransmissionGonorrhea gonorrhea;
+  TransmissionEvents transmission_events;
+  Output output;
 };
 
 
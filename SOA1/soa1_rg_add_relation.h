@@ -25,8 +25,8 @@ update everything for this relation.
 
 #include "soa1_sv_state.h"
 #include "soa1_rg_add_relation_end_event.h"
-#include "soa1_tr_update_hiv_transmission_event.h"
-#include "soa1_tr_update_gn_transmission_event.h"
+#include "soa1_sv_transmission_update_list.h"
+#include "soa1_tr_add_short_relation_transmissions.h"
 
 #include "soa1_temp_export.h" //xxx for debugging
 
@@ -36,6 +36,13 @@ namespace rg {   // rg -> relationship generation
 inline void AddRelation(soa1::sv::State& state,
     std::pair<rg::mm::RelationRequest,rg::mm::RelationRequest> requests) {
   
+  // A request can wait a day in the matchmaker (see MatchMaker::Get), so one
+  // of them might have died since (see dem::Mortality).
+  if (state.person_list().Contains(requests.first.person_id) == false ||
+      state.person_list().Contains(requests.second.person_id) == false) {
+    return;
+  }
+
   // Now everything is set and we really start the relation (it's official!)
 
   // But first plan when it stops
@@ -51,14 +58,26 @@ inline void AddRelation(soa1::sv::State& state,
   sv::Relation r(requests.first.person_id, requests.second.person_id,
     state.time(), state.time() + duration);
 
+  // Short relations (most of them last 0 or 1 day) are never stored. Their
+  // transmissions are decided now (see tr::AddShortRelationTransmissions).
+  if (duration <= state.parameter_pack().relation_generation_duration.
+      short_relation_max_duration) {
+    tr::AddShortRelationTransmissions(state, r);
+    ++state.n_short_relations();
+    soa1::NewRelation(state, r); // For export
+    return;
+  }
+
   // Store this relation in the system state
   state.relation_list().Insert(r);
   // Add events which can happen in a relation.
   rg::AddRelationEndEvent(state, r.relation_id(), state.time() + duration);
-  tr::UpdateHIVTransmissionEvent(state, r);
-  tr::UpdateGNTransmissionEvent(state, r);
+  // The transmission events are added at the end of the priority (see 
+  // sv::TransmissionUpdateList).
+  state.transmission_update_list().Add(r.relation_id(),
+      sv::transmission_update::ALL);
 
-  soa1::NewRelation(state, r.relation_id()); // For export
+  soa1::NewRelation(state, r); // For export
 
 } // !function AddRelation()
 
@@ -18,11 +18,18 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
 GOAL: Find a relation duration for a person and turn this into a request to
 be scheduled by the matchmaker.
 
-INPUT: A person who wants a relation and the time until that person's next
-relation.
+INPUT: 
+AddRelationRequest: A person who wants a relation and the time until that 
+  person's next relation.
+SubmitRelationRequests: -
+
+IMPLEMENTATION: AddRelationRequest only stores the request in the state's
+relation request list. SubmitRelationRequests (called once a day, just before
+matchmaking) gets the durations of all requests of the day in one batch and
+passes them all to the matchmaker.
 
 OUTPUT: -
-EFFECT: Adds a relation_request to the matchmaker.
+EFFECT: Adds relation_requests to the matchmaker.
 */
 
 #ifndef SOA1_RG_ADD_RELATION_REQUEST_H
@@ -33,15 +40,26 @@ EFFECT: Adds a relation_request to the matchmaker.
 namespace soa1 { // soa is the dutch equivalent of sti
 namespace rg {   // rg -> relationship generation
 
-void AddRelationRequest(soa1::sv::State& state, int person_id, 
+void AddRelationRequest(soa1::sv::State& state, const sv::Person& person, 
     int interrelation_time) {
 
-  // Call the soa1::rg::dur::GetDuration class.
-  int duration_in_days = state.get_duration().Get(interrelation_time);
-  soa1::rg::mm::RelationRequest rr;
-  rr.person_id = person_id;
-  rr.duration_in_days = duration_in_days;
-  state.matchmaker().AddRelationRequest(rr);
+  state.relation_request_list().Add(person.id(), person.day_of_birth(), 
+      interrelation_time);
+}
+
+void SubmitRelationRequests(soa1::sv::State& state) {
+  sv::RelationRequestList& list = state.relation_request_list();
+  if (list.empty()) return;
+
+  // Call the soa1::rg::dur::GetDuration class for the whole day at once.
+  std::vector<int> durations_in_days = 
+      state.get_duration().Get(list.interrelation_times());
+  std::vector<rg::mm::RelationRequest>& requests = list.requests();
+  for (int i = 0; i < static_cast<int>(requests.size()); ++i) {
+    requests[i].duration_in_days = durations_in_days[i];
+  }
+  state.matchmaker().AddRelationRequests(requests);
+  list.clear();
 }
 
 }// !namespace rg
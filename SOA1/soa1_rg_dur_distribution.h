@@ -20,8 +20,25 @@ GOAL: Provide a distribution for the relationship duration
 INPUT: A quantile (value between 0 and 1). 0 will result in a very short
 relation time 1 will result in a very long relation time.
 
-IMPLEMENTATION: Currently we use a gamma distribution for which the mean and
-variance can be set in the parameters_pack.
+INPUT ON CONSTRUCTION: The type of distribution ("gamma", "lognormal" or 
+"weibull", other types throw std::invalid_argument), its mean and variance (in
+days) and the maximum error (in days) allowed in the returned durations.
+
+IMPLEMENTATION: Calculating a quantile (e.g. boost::math::quantile on a gamma 
+distribution) is an iterative solve, too slow to do for every relation 
+request. So on construction we tabulate the quantile function on an equally
+spaced grid of percentiles between kTableLow and kTableHigh and interpolate 
+linearly in between. The grid is refined (doubled) until the interpolation 
+error, measured between every pair of grid points, is below max_error. 
+Durations are rounded down to whole days later on so an error of 0.01 day 
+changes only the durations which are within 0.01 of a whole day.
+The tails (below kTableLow and above kTableHigh) are steep so there the exact 
+quantile is used. This happens for 0.2% of the calls.
+Since the quantile function is increasing and the interpolation is linear the
+result is monotone.
+
+Other distributions can be added in the constructor by supplying the quantile
+function of a distribution with the given mean and variance.
 
 OUPUT: A relationship duration.
 */
@@ -30,8 +47,16 @@ OUPUT: A relationship duration.
 #define ALJE_RG_DUR_DISTRIBUTION_H
 
 #include <string>
+#include <vector>
+#include <cmath>
 #include <cassert>
+#include <algorithm>  // For max
+#include <functional> // For storing the exact quantile function
+#include <stdexcept>  // For invalid_argument
 #include <boost/math/distributions/gamma.hpp>
+#include <boost/math/distributions/lognormal.hpp>
+#include <boost/math/distributions/weibull.hpp>
+#include <boost/math/special_functions/gamma.hpp> // For tgamma (weibull)
 
 namespace soa1 { // soa is the dutch equivalent of sti
 namespace rg {   // rg -> relationship generation
@@ -40,30 +65,116 @@ namespace dur {  // dur-> duration
 class Distribution {
 public:
 
-  double DurationGivenPercentile(double percentile) {
-    return boost::math::quantile(gamma_distribution_, percentile);
+  double DurationGivenPercentile(double percentile) const {
+    if (percentile < kTableLow || percentile > kTableHigh) {
+      return exact_quantile_(percentile); // See top (tails)
+    }
+    double position = (percentile - kTableLow) * grid_points_per_unit_;
+    int i = static_cast<int>(position);
+    if (i >= static_cast<int>(table_.size()) - 1) {
+      i = static_cast<int>(table_.size()) - 2; // percentile == kTableHigh
+    }
+    double fraction = position - i;
+    return table_[i] + fraction * (table_[i + 1] - table_[i]);
   }
 
   // In order to be able to easily change the underlying distribution we 
   // construct the distribution using mean and variance
-  Distribution(std::string type, double mean, double variance) : 
-        gamma_distribution_(mean * mean / variance, variance / mean) {
-    // This an additional check to ensure that people watching only the
-    // parameterpack know the type of distribution
-    assert(type == "gamma" &&  "Error in soa1::rg::dur::distribution "
-      "the distribution process uses a gamma distribution but in the paramters"
-      " pack another distribution has been specified.");
-    assert(mean * mean >= variance && "Error in soa1::rg::dur::distribution "
-      "the distribution tried to initialize with a variance smaller than "
-      "mean^2 which cannot occur for a positive function. Sorry :-)");
+  Distribution(std::string type, double mean, double variance, 
+      double max_error = 0.01) {
+    assert(mean > 0 && variance > 0 && "Error in soa1::rg::dur::distribution "
+      "the mean and variance of a duration distribution need to be "
+      "positive.");
+    assert(max_error > 0 && "Error in soa1::rg::dur::distribution the "
+      "maximum error of the quantile table needs to be positive.");
+
+    if (type == "gamma") {
+      boost::math::gamma_distribution<> gamma(mean * mean / variance, 
+          variance / mean);
+      exact_quantile_ = [gamma](double p) {
+        return boost::math::quantile(gamma, p);
+      };
+    } else if (type == "lognormal") {
+      double sigma_squared = std::log(1 + variance / (mean * mean));
+      boost::math::lognormal_distribution<> lognormal(
+          std::log(mean) - sigma_squared / 2, std::sqrt(sigma_squared));
+      exact_quantile_ = [lognormal](double p) {
+        return boost::math::quantile(lognormal, p);
+      };
+    } else if (type == "weibull") {
+      double shape = WeibullShape(variance / (mean * mean));
+      boost::math::weibull_distribution<> weibull(
+          shape, mean / boost::math::tgamma(1 + 1 / shape));
+      exact_quantile_ = [weibull](double p) {
+        return boost::math::quantile(weibull, p);
+      };
+    } else {
+      // Also in release builds: without a quantile function BuildTable would
+      // fail with a much less helpful error.
+      throw std::invalid_argument("Error in soa1::rg::dur::distribution in "
+        "the parameter pack the distribution \"" + type + "\" has been "
+        "specified which is not supported. Use gamma, lognormal or weibull.");
+    }
+    BuildTable(max_error);
   }
 
   Distribution() = delete; // We need to know which gamma distribution
   // Copyable & assignable: yes
 
 private:
-  boost::math::gamma_distribution<> gamma_distribution_;
+  // The part of the quantile function which is tabulated (see top).
+  static constexpr double kTableLow = 0.001;
+  static constexpr double kTableHigh = 0.999;
+  static const int kMaxGridPoints = 1 << 20; // Refine no further than this.
+
+  std::function<double(double)> exact_quantile_;
+  std::vector<double> table_; // table_[i] = quantile(kTableLow + i / points)
+  double grid_points_per_unit_; // Number of intervals per unit percentile.
+
+  void BuildTable(double max_error) {
+    int n_intervals = 64;
+    while (true) {
+      double step = (kTableHigh - kTableLow) / n_intervals;
+      grid_points_per_unit_ = n_intervals / (kTableHigh - kTableLow);
+      table_.clear();
+      for (int i = 0; i <= n_intervals; ++i) {
+        table_.push_back(exact_quantile_(kTableLow + i * step));
+      }
+      // Check the error in the middle of every interval (the error of linear
+      // interpolation is largest around there).
+      double largest_error = 0;
+      for (int i = 0; i < n_intervals; ++i) {
+        double p = kTableLow + (i + 0.5) * step;
+        largest_error = std::max(largest_error,
+            std::abs(DurationGivenPercentile(p) - exact_quantile_(p)));
+      }
+      if (largest_error <= max_error || 2 * n_intervals > kMaxGridPoints) {
+        assert(largest_error <= max_error && "Error in soa1::rg::dur::"
+          "distribution the quantile table did not reach the required "
+          "accuracy. Increase the maximum error or kMaxGridPoints.");
+        return;
+      }
+      n_intervals *= 2;
+    }
+  }
 
+  static double WeibullShape(double squared_coefficient_of_variation) {
+    // The coefficient of variation of a weibull only depends on the shape:
+    // cv^2 = G(1 + 2/k) / G(1 + 1/k)^2 - 1, which decreases in k. Bisection.
+    double low = 0.1;
+    double high = 100;
+    for (int i = 0; i < 200; ++i) {
+      double shape = (low + high) / 2;
+      double g1 = boost::math::tgamma(1 + 1 / shape);
+      double cv2 = boost::math::tgamma(1 + 2 / shape) / (g1 * g1) - 1;
+      if (cv2 > squared_coefficient_of_variation) {
+        low = shape;
+      } else {
+        high = shape;
+      }
+    }
+    return (low + high) / 2;
+  }
 };//!class Distribution
 }// !namespace dur
 }// !namespace rg
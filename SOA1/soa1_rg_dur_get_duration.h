@@ -18,12 +18,15 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
 GOAL: The main class which given the time until the next relation gives the
 duration of the relation.
 
-INPUT: Time until the next relation of this person.
+INPUT: Time until the next relation of this person (or a vector of these 
+for a batch).
 
 IMPLEMENTATION: 
 Step 1: Find out which percentile the interrelation belongs to 
         (0=shortest 1 =longest) using the values_to_percentiles class.
-Step 2: Draw a random number between 0 and 1.
+Step 2: Draw a random number between 0 and 1. For a batch the random numbers
+        of all requests are drawn at once (sv::CounterRng::Fill) and the 
+        other steps are done in one loop over them.
 Step 3: Combine the values of step 1 and 2 using distribution free association.
         That class ensures a homogenous output between 0 and 1. As a weight for
         the values of step 1 and 2 vary between 
@@ -38,7 +41,8 @@ you want relations to take at least 1 day I suggest you add 1.
 NOTE: A thing which kind of breaks encapsulation is that this class needs the
 distribution of the interrelationtimes. For more ease of use this class
 approximates this distribution by the first X interrelation times. So if the 
-interrelationtime distribution changes this will break this class.
+interrelationtime distribution changes this will break this class, unless
+forgetting is switched on (see the RelationDuration parameters).
 
 NOTE2: This class might result in durations which are slightly lower on
 average than one might expect based on the dur::distribution. This can be
@@ -51,13 +55,13 @@ have the frequency underestimated by a factor 2).
 #define SOA1_RG_DUR_GET_DURATION_H
 
 #include <utility> // For pair which is returned by values_to_percentiles. 
-#include <random>  // For if we have duplicates in interrelation times
+#include <vector>  // For batches of durations
 
-#include "alje_rng_seed_generator.h"
 #include "alje_distribution_free_association.h"
 #include "soa1_parameters_pack.h"
 #include "soa1_rg_dur_values_to_percentiles.h"
 #include "soa1_rg_dur_distribution.h"
+#include "soa1_sv_counter_rng.h"
 
 namespace soa1 {  // soa is the dutch equivalent of STI
 namespace rg {    // rg -> relationship generation
@@ -66,7 +70,82 @@ namespace dur {   // dur -> Duration
 class GetDuration {
 public:
   int Get(int interrelation_time) {
+    // Uses the same random numbers as a batch of one.
+    CounterRngResult bits[kUniformsPerRequest];
+    rng_.Fill(bits, bits + kUniformsPerRequest);
+    return Duration(interrelation_time, ToUnit(bits[0]), ToUnit(bits[1]));
+  }
+
+  std::vector<int> Get(const std::vector<int>& interrelation_times) {
+    // The durations of a batch of interrelation times. All random numbers of
+    // the batch are drawn at once (kUniformsPerRequest per request, also if
+    // a request does not use them all) so the results do not depend on
+    // batching.
+    int n = static_cast<int>(interrelation_times.size());
+    bits_.resize(static_cast<std::size_t>(n) * kUniformsPerRequest);
+    if (n > 0) rng_.Fill(bits_.data(), bits_.data() + bits_.size());
+
+    std::vector<int> durations(n);
+    const CounterRngResult* bits = bits_.data();
+    for (int i = 0; i < n; ++i) {
+      durations[i] = Duration(interrelation_times[i], 
+          ToUnit(bits[kUniformsPerRequest * i]), 
+          ToUnit(bits[kUniformsPerRequest * i + 1]));
+    }
+    return durations;
+  }
+
+  GetDuration(    // Input parameters
+    soa1::parameters::RelationDuration dur_parameters, 
+    sv::CounterRng rng
+  ):
+    val_to_percentile_(
+      dur_parameters.percentile_max_samples,
+      dur_parameters.percentile_forgetting_half_life
+    ),
+    association_( // Initializiation list
+      {1.0 - dur_parameters.monogamy, dur_parameters.monogamy}
+    ), // See top->implem
+    rng_(rng),
+    duration_distribution_(
+      dur_parameters.distribution, 
+      dur_parameters.mean,
+      dur_parameters.variance,
+      dur_parameters.quantile_table_max_error
+    ),
+    association_values_(2)
+  {               // Constructor body
+      assert(dur_parameters.monogamy >= 0 && dur_parameters.monogamy <= 1 && 
+        "Error in "
+        "soa1::rg::dur::GetDuration->constructor. A monogamy parameter which "
+        "is not between 0 and 1 has been supplied");
+  }
+
+  GetDuration() = delete; // (need monogamy parameter!)
+  GetDuration(const GetDuration& s) = default; // inter_relation_to_percentile
+  GetDuration& operator=(const GetDuration& s) = delete;  
+
+private:
+  typedef sv::CounterRng::result_type CounterRngResult;
+  // One for a percentile within a range of duplicates and one for the 
+  // association (see Duration).
+  static const int kUniformsPerRequest = 2;
+
+  soa1::rg::dur::ValuesToPercentiles val_to_percentile_;
+  alje::DistributionFreeAssociation association_;
+  sv::CounterRng rng_;
+  soa1::rg::dur::Distribution duration_distribution_;
+  std::vector<CounterRngResult> bits_; // Reused by every batch.
+  std::vector<double> association_values_; // Reused by every request.
 
+  // A random number in (0,1) (never exactly 0 or 1, so the quantile function
+  // stays finite).
+  static inline double ToUnit(CounterRngResult bits) {
+    return (bits + 0.5) * (1.0 / 4294967296.0); // 2^-32
+  }
+
+  int Duration(int interrelation_time, double unit_random_percentile,
+      double unit_random_association) {
     // Find out which percentile this interrelation belongs to. This is 
     // slightly more advanced than it looks because the GetPercentile class
     // bases its information about the distribution on the previous 
@@ -83,65 +162,27 @@ public:
     if (upper_percentile - lower_percentile > 0.001) {
       // In that case choose one at random in this range.
       inter_relation_percentile =
-        (upper_percentile - lower_percentile) * unit_real_distribution_(rng_)
+        (upper_percentile - lower_percentile) * unit_random_percentile
         + lower_percentile;
     }
-    // now lower_percentile contains the estimated percentile this
-    // interrelation_time belongs to.
 
     // We want duration percentiles to be partly random and partly dependent on
     // the inter_relation_time. This is done by the 
     // alje::distribution_free association class. This class also ensures that
     // if the input is homogenous between 0 and 1 so will the output be.
+    association_values_[0] = unit_random_association;
+    association_values_[1] = inter_relation_percentile;
+    double duration_percentile = 
+        association_.CombineValues(association_values_);
 
-    double duration_percentile = association_.CombineValues
-      ({unit_real_distribution_(rng_), inter_relation_percentile});
-
-    // Now this duration_percentile has an association with the
-    // interrelation_time. Now we use a distribution to convert this percentile
-    // to the value. 
+    // Now we use a distribution to convert this percentile to the value. 
     // We round down here which might result in an approximately 0.5 days
     // lower duration (but rounding down is required because otherwise the 
     // shortest duration would be underestimated by a factor 0.5)
-
-
-    auto ret_value = static_cast<int>(
+    return static_cast<int>(
       duration_distribution_.DurationGivenPercentile(duration_percentile));
-    return ret_value;
-  }
-
-  GetDuration(    // Input parameters
-    soa1::parameters::RelationDuration dur_parameters, 
-    alje::RngSeedGenerator& seed_gen
-  ):
-    association_( // Initializiation list
-      {1.0 - dur_parameters.monogamy, dur_parameters.monogamy}
-    ), // See top->implem
-    rng_(seed_gen.Get()),
-    unit_real_distribution_(0,1), 
-    duration_distribution_(
-      dur_parameters.distribution, 
-      dur_parameters.mean,
-      dur_parameters.variance
-    )
-  {               // Constructor body
-      assert(dur_parameters.monogamy >= 0 && dur_parameters.monogamy <= 1 && 
-        "Error in "
-        "soa1::rg::dur::GetDuration->constructor. A monogamy parameter which "
-        "is not between 0 and 1 has been supplied");
   }
 
-  GetDuration() = delete; // (need monogamy parameter!)
-  GetDuration(const GetDuration& s) = default; // inter_relation_to_percentile
-  GetDuration& operator=(const GetDuration& s) = delete;  
-
-private:
-  soa1::rg::dur::ValuesToPercentiles val_to_percentile_;
-  std::minstd_rand rng_;
-  std::uniform_real_distribution<> unit_real_distribution_;
-  alje::DistributionFreeAssociation association_;
-  soa1::rg::dur::Distribution duration_distribution_;
-
 };
 
 } // !namespace dur
@@ -22,13 +22,28 @@ can call it repeatedly with a single value and it will estimate a percentile
 based on all values passed so far. (so the first few calls will be really
 inaccurate).
 
-INPUT: Any integer values
-
-IMPLEMENTATION: Keeps a sorted vector of all values this class has been called
-with and determine where the new value fits in. I limit the vector to a maximum
-size of X (see code for the value of X) in order to avoid unnecessary sorting
-and unnecessary use of resources. This means that after X calls the database 
-will no longer update.
+INPUT: Any non-negative integer values (interrelation times in days). Values
+of kDomainSize - 1 or higher are all treated as kDomainSize - 1 (see
+implementation).
+
+INPUT ON CONSTRUCTION:
+* max_samples: after this many values the database no longer updates. 0 means
+  no maximum.
+* forgetting_half_life: 0 means every value counts equally. Otherwise the 
+  weight of a value halves every forgetting_half_life values added after it.
+  So the percentiles follow a drifting distribution.
+
+IMPLEMENTATION: Instead of storing the values themselves we store how much 
+weight every value has (a histogram) in a Fenwick tree (binary indexed tree). 
+This gives the total weight of all values below x in O(log D) (D = 
+kDomainSize) and adding a value is O(log D) as well, where a sorted vector 
+needs to move O(n) values on every insert. The domain needs to be bounded. 
+kDomainSize days is far longer than a lifetime so the only values which are
+clamped are the "never again" interrelation times (int max - time). These
+become ties (which GetDuration already handles).
+Forgetting is done by giving every new value a slightly higher weight than the
+previous one (instead of decreasing the weight of all stored values). Once
+the weights become too large everything is scaled down.
 
 OUTPUT: a lower and an upper percentile. This is done to allow for duplicates.
 E.g. (0,0,0,0,1) what is the percentile of a 0 here? We return a lower and
@@ -37,10 +52,8 @@ upper bound and leave this up to the calling function to decide.
 NOTE: This class is part of the SOA1 namespace but with a little effort it
 could be made into a more general class. Hence the general names. Extensions
 can include:
-i. allow any input type (templating)
+i. allow any input type (templating). Requires a bounded domain.
 ii. allow more customizability of the underlying database.
-iii. Now the underlying database is sorted at every addition (=slow)
-
 */
 
 #ifndef VALUES_TO_PERCENTILES_H
@@ -48,8 +61,8 @@ iii. Now the underlying database is sorted at every addition (=slow)
 
 #include <vector>     // For the database
 #include <utility>    // For pair (lower percentile/upper percentile)
-#include <iterator>   // For std::distance to convert iterator to key.
-#include <algorithm>  // For sorting and finding
+#include <cmath>      // For pow
+#include <cassert>
 
 namespace soa1{       // soa is the dutch word for STI
 namespace rg {        // rg -> relationship generation
@@ -58,6 +71,9 @@ namespace dur {       // dur -> duration
 class ValuesToPercentiles {
 public:
   std::pair<double, double> GetLowerUpper(int value) {
+    assert(value >= 0 && "Error in soa1::rg::dur::ValuesToPercentiles->"
+      "GetLowerUpper has been called with a negative value.");
+    if (value > kDomainSize - 1) value = kDomainSize - 1; // See top
 
     // 1. Find the percentile
     // 2. Possibly add to the database
@@ -67,29 +83,14 @@ public:
     // ----------------------
     // If there are 8 values in the database, there are 9 possible positions
     // for the new value (7 between the values in the database and 2 at the 
-    // ends)
-    double possible_positions_to_insert =
-      static_cast<double>(sample_database_.size() + 1);
-
-    // Now find the first and last position the supplied value would fit while
-    // still keeping everything sorted.
-    // lower_bound returns an iterator pointing to the first element in the 
-    //    range[first, last) that is not less than (i.e.greater or equal to) 
-    //    value.
-    // upper_bound returns an iterator pointing to the first element in the 
-    //    range[first, last) that is greater than  
-    //    value.
-    auto lower_it = std::lower_bound(sample_database_.begin(),
-      sample_database_.end(), value);
-    auto upper_it = std::upper_bound(sample_database_.begin(),
-      sample_database_.end(), value);
-    // These are iterators to the elements before which we would want to insert
-    // so these iterators (a bit coincidentally) point to the position where we
-    // would want to insert. So lower_position can be 0 if it would be the
-    // lowest value of all. So all we have to do is convert these iterators to
-    // the key, we use the distance function for this.
-    int lower_position = std::distance(sample_database_.begin(), lower_it);
-    int upper_position = std::distance(sample_database_.begin(), upper_it);
+    // ends). With weights: the new value would get weight next_weight_.
+    double possible_positions_to_insert = total_weight_ + next_weight_;
+
+    // The weight of all values lower than value is the first and the weight
+    // of all values lower or equal is the last position the supplied value
+    // would fit while still keeping everything sorted.
+    double lower_position = WeightBelow(value);
+    double upper_position = WeightBelow(value + 1);
 
     // Now, if there are 9 possible positions to insert the lower_position and
     // upper_position have values between 0 and 8. Now we don't want 0 to 
@@ -97,29 +98,69 @@ public:
     // we add 0.5 such that the lower_position can have values between 0.5 and 
     // 8.5.
     double percentile_lower =
-      (lower_position + 0.5) / possible_positions_to_insert;
+      (lower_position + 0.5 * next_weight_) / possible_positions_to_insert;
     double percentile_upper =
-      (upper_position + 0.5) / possible_positions_to_insert;
+      (upper_position + 0.5 * next_weight_) / possible_positions_to_insert;
 
     // 2. If needed add this value to the database
     // -------------------------------------------
-    // It is easy to insert the new value in the right place at the vector. We
-    // already know from part 1 that upper_it is the first element which is 
-    // greater than the supplied_value so we insert just before this (using 
-    // insert). I could have used lower_it, but this would insert at an earlier
-    // position in the vector which would therefore require more moving of
-    // values.
-    if (sample_database_.size() < 100000)
-      sample_database_.insert(upper_it, value);
+    if (max_samples_ == 0 || n_samples_ < max_samples_) {
+      Add(value, next_weight_);
+      total_weight_ += next_weight_;
+      ++n_samples_;
+      next_weight_ *= weight_growth_; // See top (forgetting)
+      if (next_weight_ > kMaxWeight) Rescale(1.0 / next_weight_);
+    }
 
     // 3. return the results.
     // ----------------------
     return std::make_pair(percentile_lower, percentile_upper);
   }
 
+  ValuesToPercentiles(int max_samples = 100000, 
+    double forgetting_half_life = 0) :
+      max_samples_(max_samples),
+      weight_growth_(forgetting_half_life > 0 ? 
+          std::pow(2.0, 1.0 / forgetting_half_life) : 1.0),
+      tree_(kDomainSize + 1, 0.0) {
+    assert(max_samples >= 0 && forgetting_half_life >= 0 && "Error in soa1::"
+      "rg::dur::ValuesToPercentiles->Constructor has been called with a "
+      "negative maximum number of samples or half life.");
+  }
+
 private:
-  std::vector<int> sample_database_; // The sample database.
+  // Large enough that the sum stays accurate, small enough to never overflow.
+  static constexpr double kMaxWeight = 1e100;
+  static const int kDomainSize = 1 << 16; // In days (about 180 years)
+
+  int max_samples_; // See top
+  int n_samples_ = 0;
+  double weight_growth_; // Weight of the next value / weight of this value
+  double next_weight_ = 1;
+  double total_weight_ = 0;
+  // The Fenwick tree, 1-based. Value v is stored at index v + 1, tree_[i] 
+  // holds the weight of indices (i - lowbit(i), i].
+  std::vector<double> tree_; 
+
+  double WeightBelow(int value) const {
+    // Total weight of the values < value (indices 1..value).
+    double weight = 0;
+    for (int i = value; i > 0; i -= i & (-i)) weight += tree_[i];
+    return weight;
+  }
+
+  void Add(int value, double weight) {
+    for (int i = value + 1; i <= kDomainSize; i += i & (-i)) {
+      tree_[i] += weight;
+    }
+  }
 
+  void Rescale(double factor) {
+    // Every node is a sum of weights so it scales along.
+    for (double& node : tree_) node *= factor;
+    total_weight_ *= factor;
+    next_weight_ *= factor;
+  }
 };//!class ValuesToPercentiles
 }// !namespace dur
 }// !namespace rg
@@ -38,6 +38,7 @@ public:
     Event(time, sv::priority::RELATION_END, -1, relation_id) {}
 
   virtual void Execute() override {
+    ++state_.n_events_executed();
     state_.relation_list().RemoveGivenRelationID(relation_id_); 
   }// !function Execute
 
@@ -17,11 +17,13 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
 #ifndef SOA1_RG_EV_MATCHMAKING_H
 #define SOA1_RG_EV_MATCHMAKING_H
 #include <cassert>
+#include <chrono>
 #include <memory> // For unique_ptr to the next MatchMaking event.
 #include "alje_event.h"
 #include "soa1_sv_priority_list.h"
 #include "soa1_sv_state.h"
 #include "soa1_rg_add_relation.h"
+#include "soa1_rg_add_relation_request.h"
 
 namespace soa1 { // SOA is the dutch equivalent of STI
 namespace rg {   // rg -> relationship generation
@@ -30,10 +32,17 @@ namespace ev {   // ev -> event
 class MatchMaking : public alje::Event {
 public:
   virtual void Execute() override {
+    ++state_.n_events_executed();
  
+    // The requests of today (RELATION_START) still need a duration.
+    rg::SubmitRelationRequests(state_);
+
     // Match people for relations
+    std::chrono::steady_clock::time_point start = 
+        std::chrono::steady_clock::now();
     std::vector<std::pair<rg::mm::RelationRequest, rg::mm::RelationRequest>>
       new_relations = state_.matchmaker().Get();
+    state_.matchmaker_time() += std::chrono::steady_clock::now() - start;
 
     // Now schedule these relations
     for (auto& relation : new_relations) rg::AddRelation(state_, relation);
@@ -37,13 +37,14 @@ public:
       Event(time, sv::priority::RELATION_START, person_id, -1){}
 
   virtual void Execute() override {
+    ++state_.n_events_executed();
  
     // Schedule the next relation
     sv::Person& this_person = state_.person_list()[person_id_];
     int next_relation_time = this_person.next_relation_time();
 
     soa1::rg::AddRelationRequest(
-        state_, person_id_, next_relation_time - state_.time());
+        state_, this_person, next_relation_time - state_.time());
     
     // This part is needed to make sure one can start multiple relations in one
     // day. 
@@ -52,7 +53,7 @@ public:
       // will be returned. 
       next_relation_time = this_person.next_relation_time();
       soa1::rg::AddRelationRequest(
-        state_, person_id_, next_relation_time - state_.time());
+        state_, this_person, next_relation_time - state_.time());
     }
 
     std::unique_ptr<alje::Event> new_relation_event = 
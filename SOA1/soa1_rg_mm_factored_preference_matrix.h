@@ -0,0 +1,235 @@
+/* SOA1, individual based STI simulation
+Copyright (C) 2015, RIVM
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+
+/*
+GOAL: The preference matrix over all groups without ever storing it.
+
+Group dimensions (age, duration, ...) are assumed to be independent (see
+group_dimension_normal). So the overall preference matrix is the Kronecker
+product of the preference matrices of the separate dimensions:
+  Preference[from][to] = dim0[from_0][to_0] * dim1[from_1][to_1] * ...
+Storing the dimensions takes sum(n_i^2) doubles. Storing the product would
+take (prod n_i)^2 doubles which for 4-5 dimensions does not fit in memory.
+
+NOTE: Only this class is O(sum(n_i^2)), the matchmaking as a whole is not.
+PartnerChoiceMatrix and LinkHandler keep a value per stored entry of Sparse()
+(every possible link from both sides), which is needed because the link
+handler remembers per link how far behind it is (that is not a product over
+the dimensions). The number of entries is the product of the nonzeros of
+every dimension (NumberOfNonZeros()), so every dimension with mixing between
+all of its groups multiplies it by n_i^2. So extra dimensions need to be
+sparse: dense ones are unsupported and Sparse() refuses to build more than
+kMaxLinks entries. Measured with the default age (13 groups, all pairs
+possible) and duration (13 groups, in-group only) dimensions plus an
+activity and a region dimension where every pair of groups mixes:
+  activity x region   groups   stored entries
+  1 x 1                  169            2,197
+  3 x 1                  507           19,773
+  3 x 4                 2,028          316,368
+  3 x 12                6,084        2,847,312
+  5 x 12               10,140        7,909,200  (above kMaxLinks)
+The matchmaking classes use about 40 bytes per stored entry, plus about 24
+bytes more while the partner choice matrix is recalculated. So 3 x 12 takes
+about 115 MB (180 MB while recalculating). A region dimension which only
+mixes with neighbouring regions keeps this down.
+
+INPUT ON CONSTRUCTION: The preference matrix of every dimension. Dimension 0 is
+the most significant one: group = ((g_0 * n_1) + g_1) * n_2 + g_2 ... so for
+two dimensions we count {0,0}, {0,1}, {0,2}, {1,0}, ...
+
+IMPLEMENTATION: Entries are computed on the fly. For every dimension and every
+row we store which columns are nonzero. The nonzero columns of an overall row
+are the cartesian product of these (in ascending order).
+
+OUTPUT: depends on the function
+* Get(from, to): a single entry of the overall preference matrix.
+* NonZeroColumns(from): row sparsity.
+* NumberOfNonZeros(): the number of entries Sparse() stores, without
+  building it.
+* Sparse(): the overall preference matrix with only the nonzero entries
+  stored (see sparse_group_matrix). Memory is proportional to the number of
+  links which can actually occur. Throws std::length_error if that is more
+  than kMaxLinks.
+*/
+#ifndef SOA1_RG_MM_FACTORED_PREFERENCE_MATRIX_H
+#define SOA1_RG_MM_FACTORED_PREFERENCE_MATRIX_H
+#include <vector>
+#include <initializer_list>
+#include <cassert>
+#include <stdexcept> // For length_error
+#include <string>
+
+#include "soa1_rg_mm_sparse_group_matrix.h"
+
+namespace soa1 { // soa is the dutch equivalent of sti.
+namespace rg {   // rg -> relationship generation
+namespace mm {   // mm -> matchmaking
+
+class FactoredPreferenceMatrix {
+public:
+  // The most links the matchmaking stores (about 160 MB, see NOTE above).
+  static const long long kMaxLinks = 4000000;
+
+  inline int NumberOfGroups() const { return n_groups_; }
+
+  inline int NumberOfDimensions() const {
+    return static_cast<int>(dimension_matrices_.size());
+  }
+
+  inline int NumberOfGroups(int dimension) const {
+    return n_groups_per_dimension_[dimension];
+  }
+
+  inline int Combine(std::initializer_list<int> coordinates) const {
+    // Turn the group numbers of the seperate dimensions into an overall group
+    // number (see top for the counting order).
+    assert(static_cast<int>(coordinates.size()) == NumberOfDimensions() &&
+      "Error in soa1::rg::mm::FactoredPreferenceMatrix->Combine was called "
+      "with the wrong number of dimensions.");
+    int group = 0;
+    int dimension = 0;
+    for (int coordinate : coordinates) {
+      group += coordinate * stride_[dimension];
+      ++dimension;
+    }
+    return group;
+  }
+
+  inline int Coordinate(int group, int dimension) const {
+    // The inverse of combine: in which group of dimension "dimension" is
+    // overall group "group"?
+    return group / stride_[dimension] % n_groups_per_dimension_[dimension];
+  }
+
+  inline double Get(int group_from, int group_to) const {
+    // Independence of the dimensions means we can multiply.
+    double value = 1;
+    for (int d = 0; d < NumberOfDimensions(); ++d) {
+      value *= dimension_matrices_[d][Coordinate(group_from, d)]
+                                     [Coordinate(group_to, d)];
+    }
+    return value;
+  }
+
+  std::vector<int> NonZeroColumns(int group_from) const {
+    // Expand dimension by dimension. Since dimension 0 has the largest stride
+    // and every per-dimension list is sorted the result is sorted as well.
+    std::vector<int> columns{0};
+    for (int d = 0; d < NumberOfDimensions(); ++d) {
+      const std::vector<int>& nonzero =
+          nonzero_columns_[d][Coordinate(group_from, d)];
+      std::vector<int> expanded;
+      expanded.reserve(columns.size() * nonzero.size());
+      for (int base : columns) {
+        for (int column : nonzero) {
+          expanded.push_back(base + column * stride_[d]);
+        }
+      }
+      columns.swap(expanded);
+    }
+    return columns;
+  }
+
+  long long NumberOfNonZeros() const {
+    // The nonzero columns of a row are the cartesian product of those of the
+    // dimensions, so the total is the product of the per-dimension totals.
+    long long n_nonzeros = 1;
+    for (const auto& nonzero : nonzero_columns_) {
+      long long n_dimension = 0;
+      for (const std::vector<int>& row : nonzero) n_dimension += row.size();
+      n_nonzeros *= n_dimension;
+    }
+    return n_nonzeros;
+  }
+
+  SparseGroupMatrix Sparse() const {
+    long long n_links = NumberOfNonZeros();
+    if (n_links > kMaxLinks) {
+      throw std::length_error("Error in soa1::rg::mm::FactoredPreferenceMatrix"
+          "->Sparse the group dimensions allow " + std::to_string(n_links) +
+          " links, the maximum is " + std::to_string(kMaxLinks) + ". Dense "
+          "dimensions (every pair of groups mixes) are unsupported, make the "
+          "extra dimensions sparse.");
+    }
+    std::vector<int> row_start{0};
+    std::vector<int> columns;
+    for (int from = 0; from < n_groups_; ++from) {
+      std::vector<int> row_columns = NonZeroColumns(from);
+      columns.insert(columns.end(), row_columns.begin(), row_columns.end());
+      row_start.push_back(static_cast<int>(columns.size()));
+    }
+    SparseGroupMatrix return_matrix(std::move(row_start), std::move(columns));
+    for (int from = 0; from < n_groups_; ++from) {
+      for (int entry = return_matrix.RowBegin(from);
+          entry < return_matrix.RowEnd(from); ++entry) {
+        return_matrix.Value(entry) = Get(from, return_matrix.Column(entry));
+      }
+    }
+    return return_matrix;
+  }
+
+  FactoredPreferenceMatrix(
+      std::vector<std::vector<std::vector<double>>> dimension_matrices) :
+      dimension_matrices_(std::move(dimension_matrices)) {
+    assert(dimension_matrices_.size() > 0 && "Error in soa1::rg::mm::"
+      "FactoredPreferenceMatrix->Constructor needs at least 1 dimension.");
+
+    for (const auto& matrix : dimension_matrices_) {
+      int n = static_cast<int>(matrix.size());
+      n_groups_per_dimension_.push_back(n);
+
+      // A column is "nonzero" if either [row][column] or [column][row] is
+      // nonzero. This keeps the pattern symmetric (a link between group i and
+      // j is the same as a link between j and i).
+      std::vector<std::vector<int>> nonzero(n);
+      for (int row = 0; row < n; ++row) {
+        assert(static_cast<int>(matrix[row].size()) == n && "Error in soa1::"
+          "rg::mm::FactoredPreferenceMatrix->Constructor a dimension has a "
+          "non-square preference matrix.");
+        for (int column = 0; column < n; ++column) {
+          if (matrix[row][column] != 0 || matrix[column][row] != 0) {
+            nonzero[row].push_back(column);
+          }
+        }
+      }
+      nonzero_columns_.push_back(std::move(nonzero));
+    }
+
+    // The last dimension counts fastest.
+    stride_.resize(dimension_matrices_.size());
+    n_groups_ = 1;
+    for (int d = NumberOfDimensions() - 1; d >= 0; --d) {
+      stride_[d] = n_groups_;
+      n_groups_ *= n_groups_per_dimension_[d];
+    }
+  }
+
+  FactoredPreferenceMatrix() = delete; // We need dimensions.
+
+private:
+  // dimension_matrices_[d][i][j] = the preference matrix of dimension d.
+  std::vector<std::vector<std::vector<double>>> dimension_matrices_;
+  // nonzero_columns_[d][i] = sorted columns j for which dimension d allows
+  // a link between i and j.
+  std::vector<std::vector<std::vector<int>>> nonzero_columns_;
+  std::vector<int> n_groups_per_dimension_;
+  std::vector<int> stride_; // See Combine()
+  int n_groups_;
+};//!class FactoredPreferenceMatrix
+}// !namespace mm
+}// !namespace rg
+}// !namespace soa1
+#endif // !SOA1_RG_MM_FACTORED_PREFERENCE_MATRIX_H
@@ -17,6 +17,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
 /*
 GOAL: Division in groups and allow for only within-group preferences (hence exact)
 
+IMPLEMENTATION: Most values passed to GroupNumber are small (relation 
+durations of a couple of days) so for the first kLookupTableSize values the
+group is stored in a table. Larger values use a binary search.
+
 NOTE: See group_dimension_normal for more details. (also on functions)
 */
 #ifndef SOA1_RG_MM_GROUP_DIMENSION_EXACT_H
@@ -32,14 +36,20 @@ namespace mm {   // mm -> matchmaking
 
 class GroupDimensionExact{
 public:
-   int GroupNumber(int value) {
+  int GroupNumber(int value) const {
     assert(value >= lowest_ && value <= highest_ && "Error in "
       "soa1::rg::mm::GroupDimensionExact->GroupNumber a value has been passed "
       "which isn't in any group.");
 
-    // Subtracting random iterators gives an integer which is the distance.
-    return std::lower_bound(g_upper_.begin(), g_upper_.end(), value) 
-        - g_upper_.begin();
+    // Use the table if we can. The subtraction is done in unsigned so values
+    // below lowest_ (only possible without asserts) do not index the table.
+    unsigned int table_index = static_cast<unsigned int>(value) - 
+        static_cast<unsigned int>(lowest_);
+    if (table_index < group_by_value_.size()) {
+      return group_by_value_[table_index];
+    }
+
+    return GroupNumberBinarySearch(value);
   }
 
   std::vector<std::vector<double>> PreferenceMatrix() const {
@@ -92,13 +102,30 @@ public:
     assert(std::is_sorted(g_upper_.begin(), g_upper_.end()) && "Error in soa1"
       "::rg::mm::GroupDimensionExact>Constructor has been called with non-"
       "ascending groups.");
+
+    // Fill the lookup table (see top). Don't go past the highest value (which
+    // can be std::numeric_limits<int>::max()).
+    for (long long value = lowest_; value <= highest_ && 
+        value < lowest_ + kLookupTableSize; ++value) {
+      group_by_value_.push_back(
+          GroupNumberBinarySearch(static_cast<int>(value)));
+    }
   }// !Constructor
 
 private:
+  static const int kLookupTableSize = 4096;
+  // group_by_value_[value - lowest_] is the group of value.
+  std::vector<int> group_by_value_;
   std::vector<int> g_lower_;
   std::vector<int> g_upper_; // The upper limits of the groups (including).
   int lowest_; // Lowest value still allowed to be in a group.
   int highest_;// Highest value still allowed to be in a group.
+
+  int GroupNumberBinarySearch(int value) const {
+    // Subtracting random iterators gives an integer which is the distance.
+    return std::lower_bound(g_upper_.begin(), g_upper_.end(), value) 
+        - g_upper_.begin();
+  }
 };//!class GroupDimensionExact
 }// !namespace mm
 }// !namespace rg
@@ -19,19 +19,31 @@ GOAL: Provide an abstraction layer which turns relation_requests into
 group numbers. And also specifies preferences between the groups.
 
 INPUT:Relation_Requests
-INPUT on construction: time&, person list& (for getting the age of people)
-  and the groups as specified in the parameters.
+INPUT on construction: time& (for getting the age of people) and the groups
+  as specified in the parameters.
 
 IMPLEMENTATION: The most complex part is getting the preferences between
 groups. For this (at the moment) it assumes 2 dimensions: age and duration. 
 These are assumed to be independent. This allows much work to be done by the
-mm::group_dimension_... classes and we only need to combine them.
+mm::group_dimension_... classes and we only need to combine them. Combining
+is done by mm::FactoredPreferenceMatrix which never stores the full
+(n_age * n_duration)^2 matrix. Adding a dimension (e.g. sexual activity)
+means adding a group_dimension member, passing its preference matrix to
+preference_matrix_ and its group number to the Combine call in GroupNumber.
+The matchmaking stores every possible link, so a dimension in which every
+pair of groups mixes multiplies memory by n^2 (see
+mm::FactoredPreferenceMatrix::kMaxLinks).
+GroupNumber is called for every relation request so the age group is looked
+up in a table indexed by age in days. Indexing by age (instead of day of 
+birth) means the table never has to be refreshed when time moves on. Ages 
+outside the table fall back to age_dimension_.
 
 OUTPUT: depends on the function
 * The total number of groups
 * A groupnumber
 * Preferencematrix[i,j]. If someone from group i could choose any partner what
-  is the probability that he chooses someone from group j?
+  is the probability that he chooses someone from group j? Returned in
+  factored form (see mm::FactoredPreferenceMatrix).
 */
 
 #ifndef SOA1_RG_MM_GROUP_HANDLER_H
@@ -40,13 +52,14 @@ OUTPUT: depends on the function
 #include <string> // For returning the name of the group (for debugging)
 #include <cassert>
 #include <algorithm> // For lower_bound
+#include <cmath> // For ceil
 
 #include "soa1_rg_mm_relation_request.h"
 #include "soa1_rg_mm_group_dimension_normal.h"
 #include "soa1_rg_mm_group_dimension_exact.h"
+#include "soa1_rg_mm_factored_preference_matrix.h"
 
 #include "soa1_parameters_pack.h"
-#include "soa1_sv_person_list.h"
 
 namespace soa1 { // soa is the dutch equivalent of sti.
 namespace rg {   // rg -> relationship generation
@@ -54,75 +67,47 @@ namespace mm {   // mm -> matchmaking
 
 class GroupHandler {
 public:
-   int GroupNumber(RelationRequest request) {
-    int person_id = request.person_id;
+  int GroupNumber(const RelationRequest& request) const {
     int duration = request.duration_in_days;
-    double person_age_years =
-      (time_ - person_list_[person_id].day_of_birth()) / 365.0;
-
-    int age_group = age_dimension_.GroupNumber(person_age_years);
+    int age_in_days = time_ - request.day_of_birth;
+
+    int age_group;
+    int table_index = age_in_days - age_table_first_day_;
+    if (table_index >= 0 && 
+        table_index < static_cast<int>(age_group_by_day_.size())) {
+      age_group = age_group_by_day_[table_index];
+    } else {
+      age_group = age_dimension_.GroupNumber(age_in_days / 365.0);
+    }
     int duration_group = duration_dimension_.GroupNumber(duration);
-    return age_group * duration_dimension_.NumberOfGroups() + duration_group;
+    return preference_matrix_.Combine({age_group, duration_group});
   }// !GroupNumber(...)
   
   int NumberOfGroups() {
-    return age_dimension_.NumberOfGroups() * duration_dimension_.NumberOfGroups();
+    return preference_matrix_.NumberOfGroups();
   }
 
-  std::vector<std::vector<double>> PreferenceMatrix() {
-    int n = this->NumberOfGroups();
-    // Initialize empty matrix
-    std::vector<std::vector<double>> return_matrix(n, std::vector<double>(n));
-    
-    // Declare some variables. dim1 (dimension 1, in this case age)
-    // dim 2 (dimension 2, in this case duration)
-    // o (overall, the combination of the two)
-    int dim1_n_groups = age_dimension_.NumberOfGroups();
-    int dim2_n_groups = duration_dimension_.NumberOfGroups();
-    int o_n_groups = this->NumberOfGroups();
-
-    // What are the preferences of both dimensions?
-    auto dim1_pref = age_dimension_.PreferenceMatrix();
-    auto dim2_pref = duration_dimension_.PreferenceMatrix();
-
-    // We need to know PreferenceMatrix[o_from, o_to] so 
-    // loop over all these.
-    for (int o_from = 0; o_from < o_n_groups; ++o_from) {
-      for (int o_to = 0; o_to < o_n_groups; ++o_to) {
-        // Combine the 2. We put dim2 second and count as follows
-        // so {0,0}, {0,1}, {0,2}, {1,0)... The next 4 lines do the counting
-        // this way.
-        int dim1_from = o_from / dim2_n_groups;
-        int dim2_from = o_from % dim2_n_groups;
-        int dim1_to = o_to / dim2_n_groups;
-        int dim2_to = o_to % dim2_n_groups;
-
-        // No we properly looped over everything and we can use our assumption
-        // of independence to get the overall preference matrix from the
-        // preferences on the seperate dimensions.
-        return_matrix[o_from][o_to] = 
-            dim1_pref[dim1_from][dim1_to] * dim2_pref[dim2_from][dim2_to];
-      }
-    }
-    // And we are done :).
-    return return_matrix;
-   }// !PreferenceMatrix
+  mm::FactoredPreferenceMatrix PreferenceMatrix() {
+    // The preferences of the seperate dimensions are combined using our
+    // assumption of independence. See mm::FactoredPreferenceMatrix.
+    return preference_matrix_;
+  }// !PreferenceMatrix
 
-    std::string GroupName(int group_nr) {
-    int age_group = group_nr / duration_dimension_.NumberOfGroups();
-    int duration_group = group_nr % duration_dimension_.NumberOfGroups();
+  std::string GroupName(int group_nr) {
+    int age_group = preference_matrix_.Coordinate(group_nr, 0);
+    int duration_group = preference_matrix_.Coordinate(group_nr, 1);
 
-    return "Age group: " + age_dimension_.Name(age_group) = " Duration group: "
+    return "Age group: " + age_dimension_.Name(age_group) + " Duration group: "
       + duration_dimension_.Name(duration_group);
   }
 
-  GroupHandler(int& time, soa1::sv::PersonList& person_list, 
-    soa1::parameters::MatchMaking mm_parameters) : 
+  GroupHandler(int& time, soa1::parameters::MatchMaking mm_parameters) : 
       time_(time), 
-      person_list_(person_list),
       age_dimension_(mm_parameters.age_groups,
           mm_parameters.age_group_preference_sd),
-      duration_dimension_(mm_parameters.duration_groups)
+      duration_dimension_(mm_parameters.duration_groups),
+      preference_matrix_({age_dimension_.PreferenceMatrix(),
+          duration_dimension_.PreferenceMatrix()})
   {
     assert(mm_parameters.age_group_preference_distribution == "normal"
       && "Error in soa1_rg_mm_group_handler->Constructor in the parameter "
@@ -136,15 +121,28 @@ public:
       "either change it into an exact fit (only in-duration group matches)"
       "or change this code.");
     // Other asserts are done in the GroupDimension classes
+
+    // Fill the age table (see top) for every whole day inside the age groups.
+    // Use the same division as the fallback so the groups are identical.
+    double lowest_age = mm_parameters.age_groups.front().front();
+    double highest_age = mm_parameters.age_groups.back().back();
+    age_table_first_day_ = static_cast<int>(std::ceil(lowest_age * 365));
+    while (age_table_first_day_ / 365.0 < lowest_age) ++age_table_first_day_;
+    for (int day = age_table_first_day_; day / 365.0 <= highest_age; ++day) {
+      age_group_by_day_.push_back(age_dimension_.GroupNumber(day / 365.0));
+    }
   }
 
   GroupHandler() = delete; // we need MatchMaking Parameters!
 private:
   int& time_; // Needed to calculate someone's age
-  // Needed because we get personID but want age.
-  soa1::sv::PersonList& person_list_; 
   mm::GroupDimensionNormal age_dimension_;
   mm::GroupDimensionExact  duration_dimension_;
+  // Needs to be below the dimensions (constructed from them).
+  mm::FactoredPreferenceMatrix preference_matrix_;
+  // age_group_by_day_[age_in_days - age_table_first_day_] is the age group.
+  std::vector<int> age_group_by_day_;
+  int age_table_first_day_;
 };//!class GroupHandler
 }// !namespace mm
 }// !namespace rg
@@ -23,7 +23,8 @@ INPUT: Varies per function, see the function in question for more details
 
 INPUT ON CONSTRUCTION: A transition matrix(i,j). This transitionmatrix gives
 for a person i the probability that he/she gets a relation with someone from
-group j.
+group j. Stored sparse (see mm::SparseGroupMatrix), later updates must have
+the same sparsity pattern.
 
 IMPLEMENTATION: At the heart of the LinkHandler is the link_list. This is a 
 container which for every link stores a value. !This value is: 
@@ -35,9 +36,10 @@ The Linkhandler has been optimized for speed in a couple of ways.
 1. It stores only unique links so a link between group 0,4 is the same as a 
   link between group 4 and 0. This is handled automatically (by std::set 
   mostly). 
-2. Link between groups which have a zero-probability of happening are set to
-  -infinity in the link_list ensuring that the do not occur. This is done
-  in the constructor.
+2. Links between groups which are not in the sparsity pattern of the
+  transition matrix are not stored at all. Links inside the pattern which
+  have a zero-probability of happening are set to -infinity in the link_list
+  ensuring that the do not occur. This is done in the constructor.
 3. It has two custom sorting options which have to be called before you can 
   use certain functions. This saves a lot of in-between sorting You can sort 
   by link, allowing you to add and remove new people to the population (and 
@@ -64,6 +66,7 @@ OUTPUT: Varies per function, see the function in question for more details.
 #include <string>    // For the logreport
 
 #include "alje_multiset_size2.h" // For storing links.
+#include "soa1_rg_mm_sparse_group_matrix.h"
 
 namespace soa1 { // soa is the dutch equivalent of sti
 namespace rg {   // rg -> relationship generation
@@ -85,13 +88,13 @@ public:
       "soa1::rg::mm::LinkHandler->Add has been called but the internal vector "
       "has not been sorted by links. Make sure you call SortByLinks before "
       "calling the add function.");
-    assert(partner_choice_matrix_.size() > 0 && "Error in soa1::rg::mm::"
-      "LinkHandler->Add has been called but the partner_choice matrix has not "
-      "been initialized.");
+    assert(partner_choice_matrix_.NumberOfEntries() > 0 && "Error in soa1::"
+      "rg::mm::LinkHandler->Add has been called but the partner_choice matrix "
+      "has not been initialized.");
     
     // Loop over every group and use the transition_matrix to determine how
     // many links would occur on average with other groups.
-    // PositionInLinkSorted is a fast way to access the correct index.
+    // link_position_ is a fast way to access the correct index.
     
     // Since a link is always between 2 persons we need to take care when
     // updating the E[number of matches based on this link]'s. 
@@ -102,10 +105,11 @@ public:
     // this number by 0.5 to get tge correct amount.
 
     for (int group_from = 0; group_from < n_groups_; ++group_from) {
-      for (int group_to = 0; group_to < n_groups_; ++group_to) {
-        link_list_[PositionInLinkSorted(group_from, group_to)].second += 
+      for (int e = partner_choice_matrix_.RowBegin(group_from);
+          e < partner_choice_matrix_.RowEnd(group_from); ++e) {
+        link_list_[link_position_[e]].second += 
             0.5 * n_people_per_group[group_from] 
-            *  partner_choice_matrix_[group_from][group_to];
+            *  partner_choice_matrix_.Value(e);
       }
     }
 
@@ -220,10 +224,10 @@ public:
       "works if the LinkList is sorted by links");
     
     // 1 person = 0.5 relation = 0.5 link.
-    for (int group_to = 0; group_to < n_groups_; ++group_to) {
-
-      link_list_[PositionInLinkSorted(remove_a_person_from, group_to)].second 
-        -= 0.5*partner_choice_matrix_[remove_a_person_from][group_to];
+    for (int e = partner_choice_matrix_.RowBegin(remove_a_person_from);
+        e < partner_choice_matrix_.RowEnd(remove_a_person_from); ++e) {
+      link_list_[link_position_[e]].second 
+        -= 0.5*partner_choice_matrix_.Value(e);
     }
   }
  
@@ -233,8 +237,8 @@ public:
     // to  first and then to second and the link numbers are unique AND default
     // sorting is ascending we do not need to provide a custom sort). 
 
-    // After having sorted in this way you can rapidly access elements by group
-    // number by using link_list_[PositionInLinkSorted(group_nr_1,group_nr_2)].
+    // After having sorted in this way you can rapidly access elements by
+    // entry of the partner choice matrix by using link_list_[link_position_[e]].
 
    std::sort(link_list_.begin(), link_list_.end()); // According to link nr
    link_list_state_ = LinkListState::SORTED_BY_LINKS;
@@ -255,22 +259,24 @@ public:
     link_list_state_ = LinkListState::SORTED_BY_VALUE;
   }
   
-  inline void UpdatePartnerChoiceMatrix(std::vector<std::vector<double>> p) {
-    partner_choice_matrix_ = p;
+  inline void UpdatePartnerChoiceMatrix(SparseGroupMatrix p) {
+    assert(p.SamePattern(partner_choice_matrix_) && "Error in soa1::rg::mm::"
+      "LinkHandler->UpdatePartnerChoiceMatrix the new matrix does not have "
+      "the same sparsity pattern as the old one.");
+    partner_choice_matrix_ = std::move(p);
   }
 
-  LinkHandler(std::vector<std::vector<double>> preference_matrix) :
-    n_groups_(preference_matrix.size()),
-    partner_choice_matrix_(preference_matrix) {
-    assert(partner_choice_matrix_.size() != 0 && "Error in soa1::rg::mm::"
+  LinkHandler(SparseGroupMatrix preference_matrix) :
+    n_groups_(preference_matrix.NumberOfGroups()),
+    partner_choice_matrix_(std::move(preference_matrix)) {
+    assert(n_groups_ != 0 && "Error in soa1::rg::mm::"
       "LinkHandler->Constructor An empty transition matrix has been passed.");
-    assert(partner_choice_matrix_.size() ==  partner_choice_matrix_[0].size() 
-      && "Error in soa1::rg::mm::LinkHandler->Constructor transition matrix "
-      "dimensions do not agree.");
     for (int i = 0; i < n_groups_; ++i) {
-      double sum_of_row = std::accumulate(
-        partner_choice_matrix_[i].begin(),
-        partner_choice_matrix_[i].end(), 0.0);
+      double sum_of_row = 0;
+      for (int e = partner_choice_matrix_.RowBegin(i);
+          e < partner_choice_matrix_.RowEnd(i); ++e) {
+        sum_of_row += partner_choice_matrix_.Value(e);
+      }
       assert(sum_of_row < 1.0001 && sum_of_row > 0.9999 && "Error in "
         "soa1::rg::mm::LinkHandler->Constructor the transition probabilities "
         "do not sum to 1");
@@ -278,13 +284,24 @@ public:
  
     // Initialize the link_list for every unique link between group i and j.
     // (so (1,3) is the same link as (3,1). To realise this we use higher and 
-    // lower here instead of i and j,
-    for (int higher = 0; higher < 
-        static_cast<int>(partner_choice_matrix_.size()); ++higher) {
-      for (int lower = 0; lower <= higher; ++lower) {
+    // lower here instead of i and j. We loop in the order in which 
+    // SortByLinks will sort, so the position of a link in the link_list 
+    // (when sorted by links) is known here.
+    link_position_.resize(partner_choice_matrix_.NumberOfEntries());
+    for (int lower = 0; lower < n_groups_; ++lower) {
+      for (int e = partner_choice_matrix_.RowBegin(lower);
+          e < partner_choice_matrix_.RowEnd(lower); ++e) {
+        int higher = partner_choice_matrix_.Column(e);
+        if (higher < lower) continue; // Stored by the row of the lower group.
+        link_position_[e] = static_cast<int>(link_list_.size());
         link_list_.emplace_back(
             std::make_pair(alje::MultiSetSize2<int>(lower,higher), 0));
-        if (partner_choice_matrix_[higher][lower] == 0) {
+        int e_higher_lower = partner_choice_matrix_.Entry(higher, lower);
+        assert(e_higher_lower != -1 && "Error in soa1::rg::mm::LinkHandler->"
+          "Constructor the transition matrix does not have a symmetric "
+          "pattern.");
+        link_position_[e_higher_lower] = link_position_[e];
+        if (partner_choice_matrix_.Value(e_higher_lower) == 0) {
           // If this link occurs with probability 0 set it's value to "-inf".
           // Note that if transition_matrix_[i][j] = 0 than necessarily also
           // does transition_matrix_[j][i], so we check one.
@@ -315,7 +332,10 @@ private:
   // that are in each group. 
   // (But n_people_in_group[i] * transition_matrix[i][j] should equal
   // n_people_in_group[j] * transition_matrix[j][i].
-  std::vector<std::vector<double>> partner_choice_matrix_;
+  SparseGroupMatrix partner_choice_matrix_;
+  // link_position_[e] is the index in link_list_ (when sorted by links) of
+  // the link belonging to entry e of partner_choice_matrix_.
+  std::vector<int> link_position_;
   
   // The most important vector. This vector stores all "links". See top for 
   // more information. 
@@ -324,22 +344,6 @@ private:
 
   LinkListState link_list_state_ = LinkListState::UNSORTED;
   
-  inline int PositionInLinkSorted(int group1, int group2) {
-    // "Predict" at which index a certain link will be. This can be done by
-    // combing the knowledge of which sets exist (0.5n^2 + 0.5*n, half of the
-    // matrix + the elements on the diagonal) and the way the standard library
-    // sorts sets. The derivation of this formula is great fun and is left for
-    // the reader.
-
-    // Reason for this prediction formula is that I expect it to be much faster
-    // than a log(group_size^2) algorithm. It's kind of a unique_unordered_map.
-
-    // Make sure group 1 is smaller so group (1,3) exists but (3,1) does not.
-    // This is required because std::set (in which the links are stored)
-    // automatically sorts this way as well.
-    if (group1 > group2) std::swap(group1, group2);
-    return group1 * (2 * n_groups_ - group1 - 1) / 2 + group2;
-  }// !PositionInLinkSorted(...)
 };//!class LinkHandler
 }// !namespace mm
 }// !namespace rg
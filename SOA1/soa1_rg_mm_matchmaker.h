@@ -18,7 +18,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
 GOAL: Matchmaker is the class which decides who gets a relation with whom.
 
 AddRelationRequest(): is called if a there is a new person which wants to
-be matched to another person.
+be matched to another person. AddRelationRequests() does the same for a
+batch of requests.
 Get(): returns a vector with the best matches.
 
 INPUT: people to schedule for a relation (id & requested relation duration)
@@ -26,7 +27,7 @@ INPUT: people to schedule for a relation (id & requested relation duration)
 INPUT ON CONSTRUCTION: 
 A class which handles all group information 
 - unique hash Function from (person_id, duration) -> groupnr
-- A PreferenceMatrix[i][j] function which returns a vector<vector<double>> 
+- A PreferenceMatrix() function which returns a mm::FactoredPreferenceMatrix
   which holds the probability that someone from group i will get a relation
   with someone from group j
 - A NumberOfGroups() function returning the number of groups
@@ -80,6 +81,9 @@ Get() is the most complex function.
     - Add people to non-priority groups
 * Check for robustness (step 2)
 * Find matches (step 4)
+* Time every step (mm::StageProfiler, only when compiled with
+  SOA1_RG_MM_PROFILE) and count the links visited in step 4 and the partner
+  choice matrix updates in step 1.
     
 OUTPUT: A vector containing all relation_requests to be scheduled. 
 
@@ -105,6 +109,8 @@ PartnerChoiceMatrix: Not everyone gets their preference. The partnerchoice
 #include "soa1_rg_mm_link_handler.h"
 #include "soa1_rg_mm_relation_request.h"
 #include "soa1_rg_mm_partner_choice_matrix.h"
+#include "soa1_rg_mm_stage_profiler.h"
+#include "soa1_sv_counter_rng.h"
 
 namespace soa1 { // soa is the dutch word for sti
 namespace rg {   // rg -> relationship generation
@@ -119,6 +125,16 @@ public:
     ++r_[group]; //Add 1 to the counter of the number of people in every group.
   }
 
+  void AddRelationRequests(const std::vector<RelationRequest>& requests) {
+    // All requests of a day at once (see rg_add_relation_request).
+    n_requests_received_ += static_cast<int>(requests.size());
+    for (const RelationRequest& rr : requests) {
+      int group = group_handler_.GroupNumber(rr);
+      relation_request_by_group_[group].push_back(rr);
+      ++r_[group];
+    }
+  }
+
   std::vector<std::pair<RelationRequest,RelationRequest>> Get() {
 
     /*
@@ -133,6 +149,7 @@ public:
 
     */
     std::vector<std::pair<RelationRequest, RelationRequest>> return_vec;
+    profiler_.StartDay();
 
     // 0. Shuffle the new arrivals. 
     // Use shuffle because it is really fast (certainly compared to picking a
@@ -141,13 +158,16 @@ public:
     for (std::vector<mm::RelationRequest>& group : relation_request_by_group_){
       std::shuffle(group.begin(), group.end(), rng_);
     }
+    profiler_.EndStage(stage::SHUFFLE);
 
     // 1. Update the percentages in groups and see if the partner choice matrix
     //    and see if the partner choice matrix can be updated
     partner_choice_matrix_.UpdateDatabase(r_);
     if (partner_choice_matrix_.IsNewMatrixAvailable() == true) {
       link_handler_.UpdatePartnerChoiceMatrix(partner_choice_matrix_.Get());
+      profiler_.CountPartnerChoiceMatrixUpdate();
     }
+    profiler_.EndStage(stage::PCM_UPDATE);
 
     // 2. robustnesscheck: 
     // GOAL:
@@ -180,17 +200,21 @@ public:
         link_handler_.RemovePerson(i);
       }
     }
+    profiler_.EndStage(stage::ROBUSTNESS_CHECK);
 
     // 3. Add the new relation_requests to the linkhandler
     //link_handler_.SortByLinks(); // Done in step 2
     link_handler_.Add(r_);
+    profiler_.EndStage(stage::ADD);
 
     // 4. scheduling!   
     // 4a. priority scheduling
     link_handler_.SortByValue(); // Needed for getting matches from linkhandler
     link_handler_.PointToTop();  // Start with most needed matches.
 
+    long long links_visited = 0; // For the profiler
     while (link_handler_.PointsToAcceptableLink()) {
+      ++links_visited;
       alje::MultiSetSize2<int> possible_match = link_handler_.Get();
       const auto g1 = possible_match.first;
       const auto g2 = possible_match.second;
@@ -208,10 +232,12 @@ public:
         link_handler_.Next();
       }
     }
+    profiler_.EndStage(stage::PRIORITY_SCHEDULING);
 
     // 4b. non-priority scheduling
     link_handler_.PointToTop(); // Now loop over the list again.
     while (link_handler_.PointsToPositiveLink()) {
+      ++links_visited;
       alje::MultiSetSize2<int> possible_match = link_handler_.Get();
       const auto g1 = possible_match.first;
       const auto g2 = possible_match.second;
@@ -228,6 +254,8 @@ public:
         link_handler_.Next();
       }
     }// !while
+    profiler_.AddLinksVisited(links_visited);
+    profiler_.EndStage(stage::NORMAL_SCHEDULING);
 
     // 5. Check for relation_requests which have been unscheduled for 2 days.
     // Remove these.
@@ -245,6 +273,7 @@ public:
       relation_request_by_group_priority_[group_nr].clear();
       r_p_[group_nr] = 0;
     }
+    profiler_.EndStage(stage::DROP_AFTER_DAY_2);
 
     // 6. Prepare the lists for the next day.
     //    Move everyone which has been unscheduled for the first day to the
@@ -252,6 +281,7 @@ public:
     //    priority group has just been emptied above.
     std::swap(relation_request_by_group_, relation_request_by_group_priority_);
     std::swap(r_, r_p_);
+    profiler_.EndStage(stage::SWAP);
 
     return return_vec;
   }// !Get()
@@ -270,26 +300,37 @@ public:
       + "Total number of relations scheduled on first day: "
       + std::to_string(n_requests_scheduled_first_day_) + "\n"
       + "Total number of relations scheduled on second day: "
-      + std::to_string(n_requests_scheduled_second_day_) + "\n";
+      + std::to_string(n_requests_scheduled_second_day_) + "\n"
+      + "Groups: " + std::to_string(group_handler_.NumberOfGroups())
+      + ", stored partner choice entries (memory scales with this): "
+      + std::to_string(group_handler_.PreferenceMatrix().NumberOfNonZeros())
+      + "\n";
 
     return_string += "\nLinkhandler supports MatchMaker.\n" +
       link_handler_.LogReport();
     return_string += "\nPartnerChoiceMatrix supports MatchMaker.\n" +
       partner_choice_matrix_.LogReport();
+    return_string += profiler_.LogReport();
     
     return return_string;
   }// !LogReport()
 
+  // Relations formed so far (every relation uses two requests).
+  long long NumberOfRelationsScheduled() const {
+    return (static_cast<long long>(n_requests_scheduled_first_day_) +
+        n_requests_scheduled_second_day_) / 2;
+  }
+
   MatchMaker(
     rg::mm::GroupHandler group_handler, 
-    rg::mm::PartnerChoiceParameters pcm_par, std::uint32_t seed)
+    rg::mm::PartnerChoiceParameters pcm_par, sv::CounterRng rng)
       : 
       group_handler_(group_handler), 
       partner_choice_matrix_(group_handler_.PreferenceMatrix(), pcm_par),
-      link_handler_(group_handler_.PreferenceMatrix()),
+      link_handler_(group_handler_.PreferenceMatrix().Sparse()),
       robustness_check_(group_handler.NumberOfGroups(),
           n_percent_unscheduled_on_day_1_bound),
-      rng_(seed){
+      rng_(rng){
 
     // Allow storage for the right number of groups. The resize function
     // automatically uses the default constructor for new elements. Since
@@ -311,7 +352,8 @@ private:
   soa1::rg::mm::PartnerChoiceMatrix partner_choice_matrix_; 
   soa1::rg::mm::LinkHandler link_handler_; // see note at top.
   soa1::rg::mm::RobustnessCheck robustness_check_; //See get step 1.
-  std::minstd_rand rng_; // See get() step 0
+  sv::CounterRng rng_; // See get() step 0
+  soa1::rg::mm::StageProfiler profiler_; // Empty unless SOA1_RG_MM_PROFILE
 
   int n_requests_received_ = 0; // For statistics, incremented at Add()
   int n_requests_scheduled_first_day_ = 0; // incremented in MatchFoundDoAll()
@@ -36,7 +36,8 @@ ii) we need to know how many people actually are in this group.
 
 INPUT: The number of people in every group adding the population.
 
-INPUT ON CONSTRUCTION: preference_matrix (see goal for details), some
+INPUT ON CONSTRUCTION: preference_matrix (see goal for details, passed in
+factored form, see mm::FactoredPreferenceMatrix), some
 parameters. Most noteworthy might be the msm_hack_enabled. Enabling this leads
 to better results but can only be done for msm.
 
@@ -63,6 +64,14 @@ OUTPUT: PartnerChoiceMatrix (see goal above for details). If the
   preference matrix was already well defined the partner choice matrix will be
   (possibly approximately) equal to the preference matrix. 
 
+NOTE: Rescaling rows and columns never turns a zero into a nonzero, so the
+partner choice matrix has the same sparsity pattern as the preference matrix.
+All matrices in this class are mm::SparseGroupMatrix with that pattern, so 
+memory and time are proportional to the number of possible links instead of
+n_groups^2. This only helps for sparse dimensions: dimensions in which every
+pair of groups can mix still add n_i^2 (see mm::FactoredPreferenceMatrix for
+measured sizes).
+
 */
 
 #ifndef SOA1_RG_MM_PARTNER_CHOICE_MATRIX_H
@@ -74,6 +83,8 @@ OUTPUT: PartnerChoiceMatrix (see goal above for details). If the
 #include <cassert>
 #include <algorithm> // for std::max
 #include "alje_historic_exponential_weighting.h"
+#include "soa1_rg_mm_factored_preference_matrix.h"
+#include "soa1_rg_mm_sparse_group_matrix.h"
 
 namespace soa1 { // soa is the dutch equivalent of sti.
 namespace rg {   // rg -> relationship generation
@@ -89,7 +100,7 @@ struct PartnerChoiceParameters {
 
 class PartnerChoiceMatrix {
 public:
-  std::vector<std::vector<double>> Get() {
+  SparseGroupMatrix Get() {
     // See top -> implementation for details.
     // Extra favour for the IsNewMatrixAvailable function: set the group
     // proportions used in this calculation. (Used there to decide if a
@@ -100,40 +111,47 @@ public:
 
     // Start the iterations with the preference matrix (but make a copy to keep
     // the original).
-    std::vector<std::vector<double>> return_vec = preference_matrix_;
+    SparseGroupMatrix return_vec = preference_matrix_;
+    std::vector<double> column_sum(n_groups_);
 
     for (int i = 0; i < n_relation_matrix_iterations_; ++i) {
       // Step 1. If everyone would get their preference this might not fit with
       //  the actual number of people in every group (everyone might love Joe,
       //  but if there is only 1 Joe this might not work).
-      for (int column = 0; column < n_groups_; ++column) {
-        double column_sum = 0;
-        for (int row = 0; row < n_groups_; ++row) {
-          column_sum += percent_in_group_estimate_[row] * 
-              return_vec[row][column];
+      //  The column sums are collected row by row (the matrix is stored by
+      //  row), every column still sums its rows in ascending order.
+      std::fill(column_sum.begin(), column_sum.end(), 0.0);
+      for (int row = 0; row < n_groups_; ++row) {
+        for (int e = return_vec.RowBegin(row); e < return_vec.RowEnd(row); ++e){
+          column_sum[return_vec.Column(e)] += percent_in_group_estimate_[row] *
+              return_vec.Value(e);
         }
+      }
+      for (int column = 0; column < n_groups_; ++column) {
         // The number of relations with someone from group column should
         // be equal with the number of people in column column.
         double rescale_by = 1;
         // If the column_sum = 0 and it should equal zero we aren't rescaling.
         // if statement needed to avoid infinity errors.
-        if (column_sum != 0 && percent_in_group_estimate_[column] != 0) {
-          rescale_by = percent_in_group_estimate_[column] / column_sum;
-        }
-        for (int row = 0; row < n_groups_; ++row) {
-          return_vec[row][column] *= rescale_by;
+        if (column_sum[column] != 0 && percent_in_group_estimate_[column] != 0){
+          rescale_by = percent_in_group_estimate_[column] / column_sum[column];
         }
+        // Reuse the vector to store the rescale factor of every column.
+        column_sum[column] = rescale_by;
+      }
+      for (int e = 0; e < return_vec.NumberOfEntries(); ++e) {
+        return_vec.Value(e) *= column_sum[return_vec.Column(e)];
       }
       // Step 2 make sure the rows in every group sum to 1 (if you're having a
       //  relation, you have to have it with someone).
       for (int row = 0; row < n_groups_; ++row) {
         double row_sum = 0;
-        for (int column = 0; column < n_groups_; ++column) {
-          row_sum += return_vec[row][column];
+        for (int e = return_vec.RowBegin(row); e < return_vec.RowEnd(row); ++e){
+          row_sum += return_vec.Value(e);
         }
         double rescale_by = 1 / row_sum;
-        for (int column = 0; column < n_groups_; ++column) {
-          return_vec[row][column] *= rescale_by;
+        for (int e = return_vec.RowBegin(row); e < return_vec.RowEnd(row); ++e){
+          return_vec.Value(e) *= rescale_by;
         }
       }
     } //!for (iterations)
@@ -203,36 +221,56 @@ public:
     return percent_in_group_estimate_[group_nr];
   }
     
-  PartnerChoiceMatrix(std::vector<std::vector<double>> preference_matrix,
+  PartnerChoiceMatrix(const FactoredPreferenceMatrix& preference_matrix,
     PartnerChoiceParameters pcm_par
     ) :
-    preference_matrix_(preference_matrix),
+    preference_matrix_(preference_matrix.Sparse()),
     weight_new_database_update_(pcm_par.weight_new_database_update),
     n_relation_matrix_iterations_(pcm_par.n_relation_matrix_iterations),
     group_estimate_error_tolerance_(pcm_par.group_estimate_error_tolerance),
-    n_groups_(static_cast<int>(preference_matrix.size())),
+    n_groups_(preference_matrix.NumberOfGroups()),
     alje_weight_(pcm_par.weight_new_database_update),
     msm_hack_enabled_(pcm_par.enable_msm_hack)
   {
     // Assertions
+    std::vector<double> column_sum(n_groups_, 0.0);
     for (int row = 0; row < n_groups_; ++row) {
-      double sum_of_row = std::accumulate(
-          preference_matrix_[row].begin(), preference_matrix_[row].end(), 0.0);
+      double sum_of_row = 0;
+      for (int e = preference_matrix_.RowBegin(row); 
+          e < preference_matrix_.RowEnd(row); ++e) {
+        sum_of_row += preference_matrix_.Value(e);
+        column_sum[preference_matrix_.Column(e)] += preference_matrix_.Value(e);
+      }
       assert(sum_of_row < 1.001 && sum_of_row > 0.999 && "Error in soa1_rg_"
         "mm_partner_choice_matrix->Constructor. A preference matrix for which "
         "the rows do not sum to 1 has been passed in.");
     }
     for (int column = 0; column < n_groups_; ++column) {
-      double column_sum = 0;
-      for (int row = 0; row < n_groups_; ++row) {
-        column_sum += preference_matrix_[row][column];
+      assert(column_sum[column] > 0 && "Error in soa1::rg::mm::"
+        "PartnerChoiceMatrix a preference matrix has been passed in which one "
+        "group/column has a sum of 0. Meaning persons in this group aren't "
+        "preferred by anyone! That is a nasty situation, not just for persons "
+        "in these group but for the algorithm as well (it cannot convert a "
+        "preference matrix to a relationmatrix this way). Best check your "
+        "input.");
+    }
+    // ProvideFinishingTouch needs [j][i] and [i][i] for every entry [i][j].
+    // Look these up once, the pattern never changes.
+    transposed_entry_.resize(preference_matrix_.NumberOfEntries());
+    diagonal_entry_.resize(n_groups_);
+    for (int row = 0; row < n_groups_; ++row) {
+      for (int e = preference_matrix_.RowBegin(row);
+          e < preference_matrix_.RowEnd(row); ++e) {
+        transposed_entry_[e] =
+            preference_matrix_.Entry(preference_matrix_.Column(e), row);
+        assert(transposed_entry_[e] != -1 && "Error in soa1::rg::mm::"
+          "PartnerChoiceMatrix->Constructor the preference matrix does not "
+          "have a symmetric pattern.");
       }
-      assert(column_sum > 0 && "Error in soa1::rg::mm::PartnerChoiceMatrix "
-        "a preference matrix has been passed in which one group/column has a "
-        "sum of 0. Meaning persons in this group aren't preferred by anyone! "
-        "That is a nasty situation, not just for persons in these group but "
-        "for the algorithm as well (it cannot convert a preference matrix to "
-        "a relationmatrix this way). Best check your input.");
+      diagonal_entry_[row] = preference_matrix_.Entry(row, row);
+      assert(diagonal_entry_[row] != -1 && "Error in soa1::rg::mm::"
+        "PartnerChoiceMatrix->Constructor a group does not allow relations "
+        "within its own group.");
     }
     // Some more initialization (do all 0);
     percent_in_group_estimate_.resize(n_groups_);
@@ -249,7 +287,9 @@ private:
   std::vector<double> percent_in_group_estimate_last_recalculation_;
   int n_database_updates_called_ = 0;          // UpdateDatabase()
   int n_get_called_ = 0;                       // Get() for statistics
-  const std::vector<std::vector<double>> preference_matrix_;// See Get()
+  const SparseGroupMatrix preference_matrix_;  // See Get()
+  std::vector<int> transposed_entry_; // Entry of [j][i] given entry of [i][j]
+  std::vector<int> diagonal_entry_;   // Entry of [i][i] given i
   const double weight_new_database_update_;    // See UpdateDatabase()
   const int n_relation_matrix_iterations_;     // See Get()
   const double group_estimate_error_tolerance_;// See IsNewMatrixAvailable()
@@ -257,8 +297,7 @@ private:
   const int n_groups_;
   bool msm_hack_enabled_ = false;             // see ProvidFinishingTouch()
 
-  std::vector<std::vector<double>> ProvideFinishingTouch(
-      std::vector<std::vector<double>>&& pcm) {
+  SparseGroupMatrix ProvideFinishingTouch(SparseGroupMatrix&& pcm) {
 
     // Polish the edges of the PartnerChoiceMatrix to ensure that exactly the
     // right number of people get scheduled. Only works for msm because this
@@ -272,27 +311,27 @@ private:
     // total relations are between i and j. For convenience lateron we will
     // assume that i,j != j,i (so in fact for i!=j the proportion of total
     // number of relation between i and j is matrix[i,j]+matrix[j,i]
-    std::vector<std::vector<double>> fullmatrix(n_groups_, 
-        std::vector<double>(n_groups_, 0));
-    
+    SparseGroupMatrix fullmatrix = pcm;
 
     // Loop over full_matrix and fill this based on pcm. Immediately calculate
     // the row sums for the next step.
     std::vector<double> row_total_div_by_group_size(n_groups_,0);
     for (int i = 0; i < n_groups_; ++i) {
-      for (int j = 0; j < n_groups_; ++j) {
+      for (int e = pcm.RowBegin(i); e < pcm.RowEnd(i); ++e) {
+        int j = pcm.Column(e);
         if (i == j)
-          fullmatrix[i][i] = percent_in_group_estimate_[i] * pcm[i][i];
+          fullmatrix.Value(e) = percent_in_group_estimate_[i] * pcm.Value(e);
         else {
           // We take a minimum here because if we don't things will crash
           // if a certain group has no members. (A group which has no members
           // can choose relations with anyone as this has no effect. But in 
           // the end there shouldn't be any relations in this group.
-          fullmatrix[i][j] = std::min(percent_in_group_estimate_[i] * 
-              pcm[i][j],percent_in_group_estimate_[j]  * pcm[j][i]);
+          fullmatrix.Value(e) = std::min(percent_in_group_estimate_[i] * 
+              pcm.Value(e), percent_in_group_estimate_[j] * 
+              pcm.Value(transposed_entry_[e]));
         }
         row_total_div_by_group_size[i] += 
-            fullmatrix[i][j] / percent_in_group_estimate_[i];
+            fullmatrix.Value(e) / percent_in_group_estimate_[i];
       }
       if (percent_in_group_estimate_[i] == 0) { // Weird case
         row_total_div_by_group_size[i] = 0; // Assume no overscheduling.
@@ -308,48 +347,49 @@ private:
     double factor = *std::max_element(row_total_div_by_group_size.begin(), 
         row_total_div_by_group_size.end());
     
-    for (auto& row : fullmatrix) {
-      for (auto& cell : row) {
-        cell = cell / factor;
-      }
+    for (int e = 0; e < fullmatrix.NumberOfEntries(); ++e) {
+      fullmatrix.Value(e) = fullmatrix.Value(e) / factor;
     }
     
     // Now we add values on the diagonal to make sure every row adds to the
     // group_size. Since group sizes sum to one, and rows now sum to group
     // sizes the total matrix will now nicely sum to 1.
     for (int i = 0; i < n_groups_; ++i) {
-      double toadd = percent_in_group_estimate_[i] -
-        std::accumulate(fullmatrix[i].begin(), fullmatrix[i].end(), 0.0);
-      fullmatrix[i][i] += toadd;
+      double toadd = percent_in_group_estimate_[i] - RowSum(fullmatrix, i);
+      fullmatrix.Value(diagonal_entry_[i]) += toadd;
     }
 
     // Now finally we need to convert back to a partner_choice matrix.
     // (rows summing to 1)
     for (int i = 0; i < n_groups_; ++i) {
-      double row_sum = std::accumulate(fullmatrix[i].begin(), fullmatrix[i].end(), 0.0);
+      double row_sum = RowSum(fullmatrix, i);
       if (row_sum != 0) {
-        for (int j = 0; j < n_groups_; ++j) {
-          fullmatrix[i][j] = fullmatrix[i][j] / row_sum;
-          double cell = fullmatrix[i][j]; 
-          if (!(cell > -100 && cell < 1000)) {
-            int asd = 5;
-          }
-        } // end of for
+        for (int e = fullmatrix.RowBegin(i); e < fullmatrix.RowEnd(i); ++e) {
+          fullmatrix.Value(e) = fullmatrix.Value(e) / row_sum;
+        }
       } else { // if row_sum == 0 (this implies the group size = 0)
         // For proper form the rows will still need to sum to 1. So we just
         // add in-group relations.
-        fullmatrix[i] = std::vector<double>(n_groups_, 0);
-        fullmatrix[i][i] = 1;
+        for (int e = fullmatrix.RowBegin(i); e < fullmatrix.RowEnd(i); ++e) {
+          fullmatrix.Value(e) = 0;
+        }
+        fullmatrix.Value(diagonal_entry_[i]) = 1;
       }
     }
 
-
-
     // Now the fullmatrix should return a "perfect" matrix in the sense that
     // rows sum to 1 and columns sum to the group sizes.
     return fullmatrix;
   }
 
+  static double RowSum(const SparseGroupMatrix& matrix, int row) {
+    double row_sum = 0.0;
+    for (int e = matrix.RowBegin(row); e < matrix.RowEnd(row); ++e) {
+      row_sum += matrix.Value(e);
+    }
+    return row_sum;
+  }
+
 };//!class PartnerChoiceMatrix
 }// !namespace mm
 }// !namespace rg
@@ -30,6 +30,9 @@ namespace mm {   // mm -> matchmaking
 struct RelationRequest {
   int person_id;
   int duration_in_days;
+  // Carried along so the GroupHandler does not need to look up the person
+  // (for every request) to find out his age.
+  int day_of_birth;
 };//!class RelationRequest
 
 }// !namespace mm
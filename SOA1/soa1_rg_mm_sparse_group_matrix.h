@@ -0,0 +1,111 @@
+/* SOA1, individual based STI simulation
+Copyright (C) 2015, RIVM
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+
+/*
+GOAL: Store a group x group matrix (preference matrix, partner choice matrix)
+without storing all the zeros. With more than two group dimensions most
+combinations of groups can never form a link (e.g. the duration dimension only
+allows in-group matches) and a dense n x n matrix no longer fits in memory.
+
+INPUT ON CONSTRUCTION: The sparsity pattern. row_start[i] is the index of the
+first stored entry of row i (row_start has n+1 elements, the last one being
+the total number of stored entries). columns[row_start[i]..row_start[i+1]) are
+the columns of the stored entries of row i, sorted ascending.
+
+IMPLEMENTATION: Compressed sparse rows. Entries are addressed by an "entry
+index" so classes which loop over the matrix (LinkHandler, PartnerChoiceMatrix)
+can keep their own per-entry bookkeeping in a plain vector aligned with the
+entries of this matrix.
+
+OUTPUT: depends on the function. Entries which are not stored are 0.
+
+NOTE: The mm classes assume the pattern is symmetric (if [i][j] is stored so
+is [j][i]). FactoredPreferenceMatrix::Sparse() guarantees this.
+*/
+#ifndef SOA1_RG_MM_SPARSE_GROUP_MATRIX_H
+#define SOA1_RG_MM_SPARSE_GROUP_MATRIX_H
+#include <vector>
+#include <cassert>
+#include <algorithm> // For lower_bound & is_sorted
+
+namespace soa1 { // soa is the dutch equivalent of sti.
+namespace rg {   // rg -> relationship generation
+namespace mm {   // mm -> matchmaking
+
+class SparseGroupMatrix {
+public:
+  inline int NumberOfGroups() const {
+    return static_cast<int>(row_start_.size()) - 1;
+  }
+
+  inline int NumberOfEntries() const {
+    return static_cast<int>(columns_.size());
+  }
+
+  // The entries of row i are RowBegin(i) <= entry < RowEnd(i).
+  inline int RowBegin(int row) const { return row_start_[row]; }
+  inline int RowEnd(int row) const { return row_start_[row + 1]; }
+  inline int Column(int entry) const { return columns_[entry]; }
+  inline double& Value(int entry) { return values_[entry]; }
+  inline const double& Value(int entry) const { return values_[entry]; }
+
+  inline int Entry(int row, int column) const {
+    // Returns the entry index of [row][column] or -1 if it is not stored.
+    // Rows are short and sorted so a binary search is fast enough for
+    // everything which is not in the inner loops.
+    auto first = columns_.begin() + row_start_[row];
+    auto last = columns_.begin() + row_start_[row + 1];
+    auto it = std::lower_bound(first, last, column);
+    if (it == last || *it != column) return -1;
+    return static_cast<int>(it - columns_.begin());
+  }
+
+  inline double Get(int row, int column) const {
+    int entry = Entry(row, column);
+    if (entry == -1) return 0;
+    return values_[entry];
+  }
+
+  inline bool SamePattern(const SparseGroupMatrix& other) const {
+    return row_start_ == other.row_start_ && columns_ == other.columns_;
+  }
+
+  SparseGroupMatrix(std::vector<int> row_start, std::vector<int> columns) :
+      row_start_(std::move(row_start)),
+      columns_(std::move(columns)),
+      values_(columns_.size(), 0.0) {
+    assert(row_start_.size() >= 2 && row_start_.front() == 0 &&
+      row_start_.back() == static_cast<int>(columns_.size()) && "Error in "
+      "soa1::rg::mm::SparseGroupMatrix->Constructor the row starts do not "
+      "match the number of columns supplied.");
+    for (int row = 0; row < NumberOfGroups(); ++row) {
+      assert(std::is_sorted(columns_.begin() + row_start_[row],
+        columns_.begin() + row_start_[row + 1]) && "Error in soa1::rg::mm::"
+        "SparseGroupMatrix->Constructor the columns of a row are not sorted.");
+    }
+  }
+
+  SparseGroupMatrix() = delete; // We need a pattern.
+
+private:
+  std::vector<int> row_start_; // See top
+  std::vector<int> columns_;   // Column of every stored entry.
+  std::vector<double> values_; // Value of every stored entry.
+};//!class SparseGroupMatrix
+}// !namespace mm
+}// !namespace rg
+}// !namespace soa1
+#endif // !SOA1_RG_MM_SPARSE_GROUP_MATRIX_H
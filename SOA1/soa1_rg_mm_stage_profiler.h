@@ -0,0 +1,137 @@
+/* SOA1, individual based STI simulation
+Copyright (C) 2015, RIVM
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+
+/*
+GOAL: Find out where MatchMaker::Get() spends its time. Get() consists of a
+number of steps (see mm_matchmaker) and which one dominates depends on the
+population size and the number of groups.
+
+INPUT:
+* StartDay() at the start of Get().
+* EndStage(stage) directly after a step of Get() has finished. The time since
+  the previous EndStage (or StartDay) is attributed to this stage.
+* AddLinksVisited(n) and CountPartnerChoiceMatrixUpdate() for the counters.
+
+INPUT ON CONSTRUCTION: -
+
+IMPLEMENTATION: Uses std::chrono::steady_clock, so one clock read per step.
+Every call to StartDay() is one day (Get() is called once a day), every 365
+days a new row is started in the table.
+Profiling is only compiled in if SOA1_RG_MM_PROFILE is defined. Otherwise
+StageProfiler is an empty class with empty inline functions which the
+compiler removes completely.
+
+OUTPUT: LogReport() gives a table with one row per simulated year: the time
+(ms) spent in every stage, the number of links visited while scheduling and
+the number of partner choice matrix updates. Empty if profiling is off.
+*/
+#ifndef SOA1_RG_MM_STAGE_PROFILER_H
+#define SOA1_RG_MM_STAGE_PROFILER_H
+#include <string>
+#ifdef SOA1_RG_MM_PROFILE
+#include <vector>
+#include <array>
+#include <chrono>
+#endif
+
+namespace soa1 { // soa is the dutch equivalent of sti.
+namespace rg {   // rg -> relationship generation
+namespace mm {   // mm -> matchmaking
+namespace stage {
+
+// The steps of MatchMaker::Get() (see mm_matchmaker).
+enum StageList {
+  SHUFFLE,             // step 0
+  PCM_UPDATE,          // step 1
+  ROBUSTNESS_CHECK,    // step 2
+  ADD,                 // step 3
+  PRIORITY_SCHEDULING, // step 4a
+  NORMAL_SCHEDULING,   // step 4b
+  DROP_AFTER_DAY_2,    // step 5
+  SWAP,                // step 6
+  FIRST = SHUFFLE, // We store a first and last to allow us to loop over
+  LAST = SWAP
+}; //!enum StageList
+} // !namespace stage
+
+#ifdef SOA1_RG_MM_PROFILE
+
+class StageProfiler {
+public:
+  inline void StartDay() {
+    if (n_days_ % 365 == 0) table_.push_back(YearRow());
+    ++n_days_;
+    last_mark_ = Clock::now();
+  }
+
+  inline void EndStage(stage::StageList stage) {
+    Clock::time_point now = Clock::now();
+    table_.back().duration[stage] += now - last_mark_;
+    last_mark_ = now;
+  }
+
+  inline void AddLinksVisited(long long n) { table_.back().links_visited += n; }
+
+  inline void CountPartnerChoiceMatrixUpdate() {
+    ++table_.back().n_pcm_updates;
+  }
+
+  std::string LogReport() const {
+    // No speed needed (only called once a year).
+    std::string return_string = "MatchMaker::Get() time per stage (ms)\n"
+      "year\tshuffle\tpcm_update\trobustness\tadd\tpriority\tnormal\t"
+      "drop_day_2\tswap\tlinks_visited\tpcm_updates\n";
+    for (int year = 0; year < static_cast<int>(table_.size()); ++year) {
+      return_string += std::to_string(year);
+      for (int s = stage::FIRST; s <= stage::LAST; ++s) {
+        return_string += "\t" + std::to_string(std::chrono::duration<double,
+            std::milli>(table_[year].duration[s]).count());
+      }
+      return_string += "\t" + std::to_string(table_[year].links_visited)
+        + "\t" + std::to_string(table_[year].n_pcm_updates) + "\n";
+    }
+    return return_string;
+  }
+
+private:
+  typedef std::chrono::steady_clock Clock;
+  struct YearRow {
+    std::array<Clock::duration, stage::LAST + 1> duration{};
+    long long links_visited = 0;
+    int n_pcm_updates = 0;
+  };
+
+  std::vector<YearRow> table_; // table_[year]
+  int n_days_ = 0;
+  Clock::time_point last_mark_;
+};//!class StageProfiler
+
+#else // Profiling is compiled out (see top).
+
+class StageProfiler {
+public:
+  inline void StartDay() {}
+  inline void EndStage(stage::StageList) {}
+  inline void AddLinksVisited(long long) {}
+  inline void CountPartnerChoiceMatrixUpdate() {}
+  std::string LogReport() const { return std::string(); }
+};//!class StageProfiler
+
+#endif// !SOA1_RG_MM_PROFILE
+}// !namespace mm
+}// !namespace rg
+}// !namespace soa1
+#endif // !SOA1_RG_MM_STAGE_PROFILER_H
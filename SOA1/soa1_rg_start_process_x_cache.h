@@ -0,0 +1,149 @@
+/* SOA1, individual based STI simulation
+Copyright (C) 2015, RIVM
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+
+/*
+GOAL: Skip the warm-up of the stationary process generator (the pre-arrivals
+of alje::ProcessXGenerator, 1000000 by default) when a run with the same
+parameters and seed has done it before.
+
+INPUT ON CONSTRUCTION: The file name prefix (empty means no cache), the
+relation start parameters, the number of pre-arrivals and the seed of the
+generator.
+
+IMPLEMENTATION: The warmed generator is stored byte for byte in the file
+prefix + hash + ".bin". The hash (64 bit FNV-1a) covers everything the
+generator is constructed from plus its size, so a file never belongs to
+other parameters (and a new alje version with another layout gets another
+file). Use:
+  1. Construct the generator with PreArrivals(warm_up): only 1 pre-arrival if
+     the file exists (it is overwritten anyway), otherwise warm_up.
+  2. Restore(generator): copies the file over the generator, or writes the
+     freshly warmed generator to the file if there was none.
+So a run which uses the cache gives exactly the same results as a run which
+does not. Copying bytes is only correct for trivially copyable types. For
+other types the cache is switched off at compile time (Enabled() is false
+and every run warms up).
+
+NOTE: The seed is part of the key. Runs with a fixed seed (benchmarks,
+reruns for debugging) profit, a run with a new seed warms up once and adds a
+file (of sizeof(alje::ProcessXGenerator) bytes).
+*/
+#ifndef SOA1_RG_START_PROCESS_X_CACHE_H
+#define SOA1_RG_START_PROCESS_X_CACHE_H
+
+#include <cstdint>
+#include <cstring>     // For memcpy
+#include <string>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits> // For is_trivially_copyable
+#include "soa1_parameters_pack.h"
+
+namespace soa1 {    // soa is the dutch word for sti
+namespace rg {      // relation generation
+namespace start {   // at what points in time does a new relationship start?
+
+template <typename Generator>
+class ProcessXCache {
+public:
+  static constexpr bool Enabled() {
+    return std::is_trivially_copyable<Generator>::value;
+  }
+
+  int PreArrivals(int warm_up_arrivals) const {
+    return found_ ? 1 : warm_up_arrivals;
+  }
+
+  // Returns true if the generator came from the file.
+  bool Restore(Generator& generator) const {
+    return Restore(generator,
+        std::integral_constant<bool, Enabled()>());
+  }
+
+  const std::string& file_name() const { return file_name_; }
+
+  ProcessXCache(const std::string& file_prefix,
+      const parameters::RelationGenerationStart& p, int n_prearrivals,
+      std::uint32_t seed) {
+    if (file_prefix.empty() || Enabled() == false) return;
+    std::uint64_t hash = kFnvOffset;
+    Hash(hash, static_cast<std::uint64_t>(sizeof(Generator)));
+    Hash(hash, p.stat_process_average);
+    Hash(hash, p.weight_average);
+    Hash(hash, p.weight_short_history);
+    Hash(hash, p.weight_long_history);
+    Hash(hash, p.short_decay_rate_days);
+    Hash(hash, p.long_decay_rate_days);
+    Hash(hash, n_prearrivals);
+    Hash(hash, seed);
+    static const char kHex[] = "0123456789abcdef";
+    std::string hex(16, '0');
+    for (int i = 15; i >= 0; --i) {
+      hex[i] = kHex[hash & 0xF];
+      hash >>= 4;
+    }
+    file_name_ = file_prefix + hex + ".bin";
+    std::ifstream file(file_name_, std::ios::binary | std::ios::ate);
+    found_ = file.is_open() &&
+        file.tellg() == static_cast<std::streamoff>(sizeof(Generator));
+  }
+
+  ProcessXCache() = delete; // We need parameters!
+
+private:
+  static const std::uint64_t kFnvOffset = 14695981039346656037ULL;
+  static const std::uint64_t kFnvPrime = 1099511628211ULL;
+
+  std::string file_name_; // Empty means no cache.
+  bool found_ = false;    // The file exists and has the right size.
+
+  template <typename T>
+  static void Hash(std::uint64_t& hash, const T& value) {
+    unsigned char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    for (unsigned char byte : bytes) {
+      hash ^= byte;
+      hash *= kFnvPrime;
+    }
+  }
+
+  bool Restore(Generator&, std::false_type) const { return false; }
+
+  bool Restore(Generator& generator, std::true_type) const {
+    if (file_name_.empty()) return false;
+    if (found_) {
+      std::ifstream file(file_name_, std::ios::binary);
+      unsigned char bytes[sizeof(Generator)];
+      file.read(reinterpret_cast<char*>(bytes), sizeof(Generator));
+      if (file.gcount() == static_cast<std::streamsize>(sizeof(Generator))) {
+        std::memcpy(static_cast<void*>(&generator), bytes, sizeof(Generator));
+        return true;
+      }
+      // The generator only had 1 pre-arrival, so we can't continue.
+      throw std::runtime_error("Error in soa1::rg::start::ProcessXCache the "
+          "cache file " + file_name_ + " could not be read.");
+    }
+    std::ofstream file(file_name_, std::ios::binary | std::ios::trunc);
+    if (file.is_open()) { // No cache if we can't write, nothing breaks.
+      file.write(reinterpret_cast<const char*>(&generator), sizeof(Generator));
+    }
+    return false;
+  }
+}; // ! class ProcessXCache
+} // ! namespace start
+} // ! namespace rg
+} // ! namespace soa1
+#endif // !SOA1_RG_START_PROCESS_X_CACHE_H
@@ -41,19 +41,19 @@ namespace start { // when do relationships start?
 class RateGivenAgeFormula {
 public:
 
-  double rate_primitive(double age_in_days){
+  double rate_primitive(double age_in_days) const {
     // See top for more info.
     double x = age_in_days; // For easier readibility below.
     return a_/4.0*x*x*x*x + b_/3.0*x*x*x + c_/2.0*x*x + d_*x;
   }
 
-  double rate_function(double age_in_days){
+  double rate_function(double age_in_days) const {
     // See top for more info.
     double x = age_in_days; // For easier readibility below.
     return a_*x*x*x + b_*x*x + c_*x + d_;
   }
 
-  double rate_derivative(double age_in_days){
+  double rate_derivative(double age_in_days) const {
     // See top for more info.
     double x = age_in_days; // For easier readibility below.
     return 3.0*a_*x*x + 2.0*b_*x+c_;
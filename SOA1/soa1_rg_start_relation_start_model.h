@@ -0,0 +1,261 @@
+/* SOA1, individual based STI simulation
+Copyright (C) 2015, RIVM
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+
+/* 
+GOAL: Everything needed to generate relation start times which is the same for
+every person: the rate given age formula, the sexual onset and stop and the
+conversion from stationary process time to person time. One instance is owned
+by the state and every person (NextRelationPersonTime) refers to it. So a
+person only stores its own stationary process.
+
+INPUT ON CONSTRUCTION: rg_parameters (relationship generation parameters)
+
+IMPLEMENTATION: See ConvertStationaryTimeToRealPersonTime. The class is 
+immutable after construction.
+
+OUTPUT: Depends on the function.
+
+MORE INFORMATION: look at the support wiki (probably www.elivian.nl) 
+*/
+#ifndef SOA1_RG_START_RELATION_START_MODEL_H
+#define SOA1_RG_START_RELATION_START_MODEL_H
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <algorithm> // For min and max
+#include "soa1_parameters_pack.h"
+#include "soa1_rg_start_rate_given_age_formula.h"
+
+namespace soa1 {    // soa is the dutch word for sti
+namespace rg {      // relation generation
+namespace start {   // at what points in time does a new relationship start?
+
+class RelationStartModel {
+public:
+  const parameters::RelationGenerationStart& parameters() const {
+    return parameters_;
+  }
+
+  // The lowest person time ConvertStationaryTimeToRealPersonTime returns.
+  double LowestPersonTime() const { return sexual_onset_ + 1; }
+
+  int WarmUpArrivals() const {
+    /*
+    GOAL: The number of arrivals the stationary process (alje::ProcessX) needs
+    to simulate before it is stationary. These are the pre-arrivals of the
+    alje::ProcessXGenerator.
+
+    IMPLEMENTATION: If stat_process_n_prearrivals is set in the parameter
+    pack we use that. Otherwise: the process only remembers its start state
+    through its histories and a history with decay rate r weighs the start
+    state by exp(-r * t) after t days. But the process excites itself: the
+    start state raises the rate, so it causes arrivals which enter the 
+    histories again. Only the weight_average part of the rate does not come
+    from the histories, so the start state fades at about r * weight_average.
+    Once the slowest decaying history (with a nonzero weight) has faded to
+    below exp(-kLogTolerance) the start state can no longer be seen in a
+    double and the process is stationary. The process has (on average)
+    stat_process_average / 365 arrivals a day. With
+    stat_process_n_prearrivals = 0 and the default rates and weights this
+    gives 106 arrivals (the default of stat_process_n_prearrivals is 1000000,
+    rg::start::ProcessXCache avoids paying for it in every run).
+    */
+    if (parameters_.stat_process_n_prearrivals > 0) {
+      return parameters_.stat_process_n_prearrivals;
+    }
+    double slowest_decay_rate = std::numeric_limits<double>::max();
+    if (parameters_.weight_short_history != 0) {
+      slowest_decay_rate = std::min(slowest_decay_rate, 
+          parameters_.short_decay_rate_days);
+    }
+    if (parameters_.weight_long_history != 0) {
+      slowest_decay_rate = std::min(slowest_decay_rate, 
+          parameters_.long_decay_rate_days);
+    }
+    // Without histories the process is stationary from the start.
+    if (slowest_decay_rate == std::numeric_limits<double>::max()) {
+      return kMinimumWarmUpArrivals;
+    }
+    assert(parameters_.weight_average > 0 && "Error in soa1::rg::start::"
+        "RelationStartModel, weight_average should be positive to derive the "
+        "number of pre-arrivals.");
+    double fade_rate = slowest_decay_rate * parameters_.weight_average;
+    double arrivals_per_day = parameters_.stat_process_average / 365.0;
+    double warm_up_days = kLogTolerance / fade_rate;
+    double warm_up_arrivals = std::ceil(warm_up_days * arrivals_per_day);
+    if (warm_up_arrivals < kMinimumWarmUpArrivals) {
+      return kMinimumWarmUpArrivals;
+    }
+    if (warm_up_arrivals > std::numeric_limits<int>::max()) {
+      return std::numeric_limits<int>::max();
+    }
+    return static_cast<int>(warm_up_arrivals);
+  }
+
+  double ConvertStationaryTimeToRealPersonTime(const double unit_stat_time,
+      const double previous_estimate) const {
+   /* 
+   GOAL: Stretch / compress the time of a stationary process (alje::process_x)
+   to fit different rates at different ages. This is done according to the 
+   functions specified in the parameter pack. In order to do this stretching /
+   compressing we need to solve an equation where at this point in time we use
+   a simple Newton Raphson estimate.
+
+   INPUT: The total time of the stationary process converted to "unit" speed
+   (multiplied by the average rate of the process) and the previous answer for 
+   this person (or LowestPersonTime() if there is none).
+
+   IMPLEMENTATION: In order to facilitate the solving we defined the formulas 
+   f and f_deriv in such a way that this function only needs to worry about 
+   solving f = 0.
+   Since the answers for a person are non-decreasing the previous answer is a
+   good first estimate and a lower bound. Usually only a few iterations are 
+   needed. Stationary times beyond the end of the sexual career are 
+   recognized without solving.
+
+   Output: The time (in days since birth) of the next relation or -1 if no
+   more relations will occur.
+   */
+
+    // Will the solution be beyond the upper bound? Then the Newton Raphson
+    // below would end at the upper bound anyway (see below).
+    if (primitive_at_upper_bound_ - primitive_at_onset_ <= unit_stat_time) {
+      return -1; // Out of bounds!
+    }
+
+    //Newton Raphson, safeguarded by bisection.
+
+    // The solution lies between the previous solution (answers are 
+    // non-decreasing) and the upper bound. Starting anywhere but halfway the
+    // sexual career plain Newton Raphson can jump back and forth between the
+    // bounds (the rate is close to 0 there). So we keep track of an interval
+    // [lower, upper] which contains the solution and bisect whenever a Newton
+    // Raphson step would leave this interval.
+    double lower = previous_estimate;
+    double upper = sexual_stop_ - 1; // f > 0 here, checked above.
+    if (f(lower, unit_stat_time) > 0) {
+      // Only possible due to the 0.1 day inaccuracy of the previous solution
+      // (or for really small stationary times).
+      lower = sexual_onset_ + 1;
+      // We do not return estimates below sexual_onset_ + 1 (stability).
+      if (f(lower, unit_stat_time) >= 0) return lower;
+    }
+
+    // A first estimation is the previous solution (see top).
+    double current_estimate = lower;
+
+    // We want it to be correct up until 1/10th of a day (just to be sure)
+    // f is defined in this class (just below this function).
+    while (true) {
+      double value = f(current_estimate, unit_stat_time);
+      if (value == 0) break; // Found it exactly.
+      if (value > 0) {
+        upper = current_estimate;
+      } else {
+        lower = current_estimate;
+      }
+
+      double next_estimate = current_estimate - value / 
+          f_deriv(current_estimate);
+      // Written such that a NaN (rate of 0) also results in bisection.
+      if (!(next_estimate > lower && next_estimate < upper)) {
+        next_estimate = (lower + upper) / 2.0;
+      }
+
+      double correction = next_estimate - current_estimate;
+      current_estimate = next_estimate;
+      if (std::abs(correction) <= 0.1 || upper - lower <= 0.1) break;
+    }
+
+    return current_estimate;
+  }
+
+  // Note that since the parameter pack is in years (and the model is in days)
+  // we need to convert the relevant variables to days.
+  RelationStartModel(
+      const parameters::RelationGenerationStart& rg_start_parameters) : 
+      parameters_(rg_start_parameters),
+      rate_formula_(rg_start_parameters),
+      sexual_onset_(rg_start_parameters.sexual_onset * 365),
+      sexual_stop_(rg_start_parameters.sexual_stop * 365) {
+    // The rate formula is the same in every call so these are fixed.
+    primitive_at_onset_ = rate_formula_.rate_primitive(sexual_onset_);
+    primitive_at_upper_bound_ = rate_formula_.rate_primitive(sexual_stop_ - 1);
+  }
+
+  RelationStartModel() = delete; // We need parameters!
+  // Persons refer to this class so never copy it by accident.
+  RelationStartModel(const RelationStartModel&) = delete;
+  RelationStartModel& operator=(const RelationStartModel&) = delete;
+
+private:
+  // See WarmUpArrivals. exp(-40) is below the precision of a double.
+  static constexpr double kLogTolerance = 40;
+  static const int kMinimumWarmUpArrivals = 100;
+
+  const parameters::RelationGenerationStart parameters_;
+  const rg::start::RateGivenAgeFormula rate_formula_;
+  const double sexual_onset_; // By default in the model everything is in days.
+  const double sexual_stop_;  // By default in the model everything is in days.
+  double primitive_at_onset_;
+  double primitive_at_upper_bound_;
+
+  inline double f(const double real_time_guess, 
+      const double unit_stat_time) const {
+    /* 
+    GOAL: Make sure the ConvertStationaryTimeToRealPersonTime function only has
+    to worry about solving f(x,constant) = 0 
+    (with the helper f_deriv provided below).
+
+    INPUT: real_time (can be thought of as the x) and the 
+       unit stationary time (can be thought of as the y, what you want to
+       solve for)
+
+    IMPLEMENTATION: 
+    int_{sexual_onset}^{real_person_time_guess}
+                  rate_given_age_formula = unit_stat_process
+    so 
+      int_{0}^{real_person_time_guess}rate_given_age_formula - 
+        int{0}^{real_person_time_guess}rate_given_age_formula=unit_stat_process
+    so the formula which should = 0 is
+      rate_formula.rate_primitive(real_time_guess) -
+        rate_formula.rate_primitive(sexual_onset_) - unit_stat_process = 0
+    OUTPUT: real_time_guess converted to unit stat time - 
+      required stationary time converted to unit stat time.
+    Or more easy: a function which will be closer to 0 as the real_time_guess
+    given the required_stat_time be closer to eachother.
+       
+    */
+
+    // For debugging we use intermediate values (a,b,c,d)
+    auto a = rate_formula_.rate_primitive(real_time_guess);
+    // Stationary time starts running at sexual onset
+    auto b = primitive_at_onset_; 
+    auto c = unit_stat_time;
+    auto d = a - b - c;
+    return d;
+  }
+
+  inline double f_deriv(const double real_time) const {
+    // The derivative of the function above, required for Newton Raphson method
+    return rate_formula_.rate_function(real_time);
+  }
+}; // ! class RelationStartModel
+} // ! namespace start
+} // ! namespace rg
+} // ! namespace soa1
+#endif // !SOA1_RG_START_RELATION_START_MODEL_H
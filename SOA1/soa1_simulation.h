@@ -22,33 +22,55 @@ the relations and what is executed when.
 #ifndef SOA1_SIMULATION_H
 #define SOA1_SIMULATION_H
 #include <memory> // For unique_ptr to matchmaking event
+#include <vector>
+#include <cassert>
 #include "alje_event.h"
 #include "soa1_sv_state.h"
 #include "soa1_dem_populate.h"
 #include "soa1_dem_births.h"
 #include "soa1_dem_ev_births.h"
+#include "soa1_dem_ev_deaths.h"
 #include "soa1_sv_person.h"
 #include "soa1_rg_add_relation.h"
 #include "soa1_export_results.h"
 #include "soa1_rg_ev_matchmaking.h"
+#include "soa1_tr_update_transmission_events.h"
+#include "soa1_tr_transmit.h"
+#include "soa1_tr_sti_traits.h"
 
 
 namespace soa1 {
 class Simulation{
 public:
-  void Start(){
+  // Create the population, infect the first persons and schedule the daily
+  // events. Call once before the first ExecuteDay.
+  void Initialize() {
 
     // Create people
-    dem::Populate(state_); 
-
-    // Infect people
-    for (int i = 0; i < 500; ++i) {
-      tr::HIVInfectPerson(state_, state_.person_list()[i]);
+    std::vector<int> person_ids = dem::Populate(state_); 
+
+    // Infect people (the first persons with HIV, the next with gonorrhea).
+    const parameters::ParameterPack& par = state_.parameter_pack();
+    int n_hiv = par.hiv.initial_n_infected;
+    int n_gn = par.gonorrhea.initial_n_infected;
+    assert(n_hiv + n_gn <= static_cast<int>(person_ids.size()) && "Error in "
+      "soa1::Simulation::Initialize more persons should be infected than "
+      "there are persons.");
+    // No infector or relation (-1), they are the roots of the transmission
+    // tree.
+    for (int i = 0; i < n_hiv; ++i) {
+      tr::Transmit<tr::sti::HIV>(state_, -1, -1, 
+          state_.person_list()[person_ids[i]]);
     }
-    for (int j = 500; j < 1000; ++j) {
-      tr::GNInfectPerson(state_, state_.person_list()[j]);
+    for (int j = n_hiv; j < n_hiv + n_gn; ++j) {
+      tr::Transmit<tr::sti::GN>(state_, -1, -1, 
+          state_.person_list()[person_ids[j]]);
     }
 
+    std::unique_ptr<alje::Event> deaths_event =
+      std::make_unique<dem::ev::Deaths>(state_, 0);
+    state_.event_manager().Add(std::move(deaths_event));
+
     std::unique_ptr<alje::Event> births_event =
       std::make_unique<dem::ev::Births>(state_, 0);
     state_.event_manager().Add(std::move(births_event));
@@ -56,19 +78,35 @@ public:
     std::unique_ptr<alje::Event> mm_event =
         std::make_unique<rg::ev::MatchMaking>(state_, 0);
     state_.event_manager().Add(std::move(mm_event));
-    
+  }// !function Initialize
+
+  void ExecutePriority(int t, int p) {
+    // Manually change the time to enforce strict seperation between the
+    // state and the executing code.
+    state_.time() = t;
+    state_.current_priority() = p;
+    long long n_events_before = state_.n_events_executed();
+    state_.event_manager().ExecuteAll(t, p);
+    n_events_executed_[p] += state_.n_events_executed() - n_events_before;
+    // The transmission events of relations which changed during this
+    // priority (see sv::TransmissionUpdateList).
+    tr::UpdateTransmissionEvents(state_);
+  }
+
+  void ExecuteDay(int t) {
+    for (int p = sv::priority::FIRST; p <= sv::priority::LAST; ++p) {
+      ExecutePriority(t, p);
+    }
+  }
+
+  void Start(){
+    Initialize();
+
     std::cout << "Started with seed: " 
       << state_.seed_generator().Seed() << "\n\n";
 
     for (int t = 0; t < 365 * 680; ++t){
-      // Manually change the time to enforce strict seperation between the
-      // state and the executing code.
-       
-      for (int p = sv::priority::FIRST; p <= sv::priority::LAST; ++p) {
-        state_.time() = t;
-        state_.current_priority() = p;
-        state_.event_manager().ExecuteAll(t, p);
-      }
+      ExecuteDay(t);
       
       /*
       state_.time() = t; 
@@ -102,11 +140,20 @@ public:
   }// !function Start
   
 
+  sv::State& state() { return state_; }
+
+  // The number of events executed in priority p so far.
+  long long n_events_executed(int p) const { return n_events_executed_[p]; }
+
+  Simulation(int seed, const parameters::ParameterPack& parameter_pack) :
+      state_(seed, parameter_pack) {}
   Simulation(int seed) : state_(seed) {}
   Simulation() : state_() {}
 
 private:
   sv::State state_; //Everything which has anything to do with the state
+  std::vector<long long> n_events_executed_ = 
+      std::vector<long long>(sv::priority::LAST + 1, 0); // Per priority
 
 };// !class Simulation
 } // !namespace soa1
@@ -0,0 +1,251 @@
+/* SOA1, individual based STI simulation
+Copyright (C) 2015, RIVM
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+
+/*
+GOAL: Find the persons of an age band (and count them, with their HIV status
+and total age) without going through the whole person list.
+
+INPUT: Add(person) when a person is added to the person list, Remove(person)
+before a person is removed and HIVInfected(person) when a person gets HIV.
+Queries take the time and an age band [min_age, max_age) in days.
+
+IMPLEMENTATION: One cohort per year of birth (day_of_birth / 365, rounded
+down) in a deque, the front cohort is the oldest one which still has someone
+in it. A cohort keeps its persons (id, day of birth, HIV) and their count,
+number with HIV and sum of days of birth (of everyone and of those with HIV).
+So a cohort which is completely
+inside a band is counted in constant time, only the (at most 2) cohorts on
+the edges of the band are gone through. The position of every person in his
+cohort is kept in a map, so Remove and HIVInfected take constant time.
+
+OUTPUT: A Band (count, number with HIV and total ages in days) or every
+Entry of a band (ForEachInAgeBand).
+
+NOTE: The persons in a cohort are not in any particular order (removing
+swaps the last one in).
+*/
+
+#ifndef SOA1_SV_AGE_COHORT_INDEX_H
+#define SOA1_SV_AGE_COHORT_INDEX_H
+#include <deque>
+#include <vector>
+#include <unordered_map>
+#include <cassert>
+#include "soa1_sv_person.h"
+
+namespace soa1 {
+namespace sv { // sv -> status variables
+
+class AgeCohortIndex {
+public:
+  struct Entry {
+    int person_id;
+    int day_of_birth;
+    bool hiv_infected;
+  };
+
+  struct Band {
+    int n = 0;
+    int n_hiv = 0;
+    long long total_age = 0;     // In days.
+    long long total_age_hiv = 0; // In days, of those with HIV.
+  };
+
+  void Add(const Person& person) {
+    Cohort& cohort = CohortOf(person.day_of_birth(), true);
+    slot_[person.id()] = static_cast<int>(cohort.entries.size());
+    cohort.entries.push_back({person.id(), person.day_of_birth(),
+        person.hiv_status().infected()});
+    cohort.sum_day_of_birth += person.day_of_birth();
+    ++n_;
+    sum_day_of_birth_ += person.day_of_birth();
+    if (person.hiv_status().infected()) AddHIV(cohort, person.day_of_birth());
+  }
+
+  void Remove(const Person& person) {
+    Cohort& cohort = CohortOf(person.day_of_birth(), false);
+    int i = Find(person.id());
+    if (cohort.entries[i].hiv_infected) {
+      --cohort.n_hiv;
+      cohort.sum_day_of_birth_hiv -= person.day_of_birth();
+      --n_hiv_;
+      sum_day_of_birth_hiv_ -= person.day_of_birth();
+    }
+    cohort.sum_day_of_birth -= person.day_of_birth();
+    cohort.entries[i] = cohort.entries.back();
+    slot_[cohort.entries[i].person_id] = i;
+    cohort.entries.pop_back();
+    slot_.erase(person.id());
+    --n_;
+    sum_day_of_birth_ -= person.day_of_birth();
+
+    // The oldest cohorts die out first.
+    while (cohorts_.empty() == false && cohorts_.front().entries.empty()) {
+      cohorts_.pop_front();
+      ++first_cohort_;
+    }
+  }
+
+  void HIVInfected(const Person& person) {
+    Cohort& cohort = CohortOf(person.day_of_birth(), false);
+    Entry& entry = cohort.entries[Find(person.id())];
+    if (entry.hiv_infected) return;
+    entry.hiv_infected = true;
+    AddHIV(cohort, person.day_of_birth());
+  }
+
+  // Everyone (constant time).
+  Band All(int time) const {
+    Band band;
+    band.n = n_;
+    band.n_hiv = n_hiv_;
+    band.total_age = static_cast<long long>(time) * n_ - sum_day_of_birth_;
+    band.total_age_hiv = static_cast<long long>(time) * n_hiv_ - 
+        sum_day_of_birth_hiv_;
+    return band;
+  }
+
+  // The persons with min_age <= age < max_age (ages in days).
+  Band InAgeBand(int time, int min_age, int max_age) const {
+    Band band;
+    int first_day = time - max_age + 1; // Days of birth in the band.
+    int last_day = time - min_age;
+    int first = FirstCohort(first_day);
+    int last = LastCohort(last_day);
+    for (int c = first; c <= last; ++c) {
+      const Cohort& cohort = cohorts_[c - first_cohort_];
+      if (c * kDaysPerYear >= first_day && 
+          c * kDaysPerYear + kDaysPerYear - 1 <= last_day) {
+        int n = static_cast<int>(cohort.entries.size());
+        band.n += n;
+        band.n_hiv += cohort.n_hiv;
+        band.total_age += static_cast<long long>(time) * n - 
+            cohort.sum_day_of_birth;
+        band.total_age_hiv += static_cast<long long>(time) * cohort.n_hiv - 
+            cohort.sum_day_of_birth_hiv;
+      } else { // On the edge of the band.
+        for (const Entry& entry : cohort.entries) {
+          if (entry.day_of_birth < first_day || entry.day_of_birth > last_day) {
+            continue;
+          }
+          ++band.n;
+          band.total_age += time - entry.day_of_birth;
+          if (entry.hiv_infected) {
+            ++band.n_hiv;
+            band.total_age_hiv += time - entry.day_of_birth;
+          }
+        }
+      }
+    }
+    return band;
+  }
+
+  // Calls f(entry) for every person with min_age <= age < max_age.
+  template <typename F>
+  void ForEachInAgeBand(int time, int min_age, int max_age, F f) const {
+    int first_day = time - max_age + 1;
+    int last_day = time - min_age;
+    int first = FirstCohort(first_day);
+    int last = LastCohort(last_day);
+    for (int c = first; c <= last; ++c) {
+      for (const Entry& entry : cohorts_[c - first_cohort_].entries) {
+        if (entry.day_of_birth >= first_day && entry.day_of_birth <= last_day) {
+          f(entry);
+        }
+      }
+    }
+  }
+
+  int size() const {return n_;}
+
+  AgeCohortIndex() = default;
+  AgeCohortIndex(const AgeCohortIndex&) = delete;
+  AgeCohortIndex& operator=(const AgeCohortIndex&) = delete;
+
+private:
+  static const int kDaysPerYear = 365;
+
+  struct Cohort {
+    std::vector<Entry> entries;
+    long long sum_day_of_birth = 0;
+    int n_hiv = 0;
+    long long sum_day_of_birth_hiv = 0;
+  };
+
+  std::deque<Cohort> cohorts_; // cohorts_[i]: born in year first_cohort_ + i
+  std::unordered_map<int, int> slot_; // person id -> index in his cohort
+  int first_cohort_ = 0;
+  int n_ = 0;
+  int n_hiv_ = 0;
+  long long sum_day_of_birth_ = 0;
+  long long sum_day_of_birth_hiv_ = 0;
+
+  void AddHIV(Cohort& cohort, int day_of_birth) {
+    ++cohort.n_hiv;
+    cohort.sum_day_of_birth_hiv += day_of_birth;
+    ++n_hiv_;
+    sum_day_of_birth_hiv_ += day_of_birth;
+  }
+
+  // The year of birth (rounded down, also for days before t = 0).
+  static int CohortNumber(int day_of_birth) {
+    if (day_of_birth >= 0) return day_of_birth / kDaysPerYear;
+    return -((-day_of_birth + kDaysPerYear - 1) / kDaysPerYear);
+  }
+
+  Cohort& CohortOf(int day_of_birth, bool create) {
+    int c = CohortNumber(day_of_birth);
+    if (cohorts_.empty()) {
+      assert(create && "Error in soa1::sv::AgeCohortIndex, the person is not "
+        "in the index.");
+      first_cohort_ = c;
+    }
+    while (c < first_cohort_) {
+      assert(create && "Error in soa1::sv::AgeCohortIndex, the person is not "
+        "in the index.");
+      cohorts_.emplace_front();
+      --first_cohort_;
+    }
+    std::size_t index = static_cast<std::size_t>(c - first_cohort_);
+    if (index >= cohorts_.size()) {
+      assert(create && "Error in soa1::sv::AgeCohortIndex, the person is not "
+        "in the index.");
+      cohorts_.resize(index + 1);
+    }
+    return cohorts_[index];
+  }
+
+  int Find(int person_id) const {
+    auto it = slot_.find(person_id);
+    assert(it != slot_.end() && "Error in soa1::sv::AgeCohortIndex, the "
+      "person is not in the index.");
+    return it->second;
+  }
+
+  // The stored cohorts which hold the first/last day of birth of a band.
+  int FirstCohort(int first_day) const {
+    int c = CohortNumber(first_day);
+    return c < first_cohort_ ? first_cohort_ : c;
+  }
+  int LastCohort(int last_day) const {
+    int c = CohortNumber(last_day);
+    int last_stored = first_cohort_ + static_cast<int>(cohorts_.size()) - 1;
+    return c > last_stored ? last_stored : c;
+  }
+};//!class AgeCohortIndex
+}// !namespace sv
+}// !namespace soa1
+#endif// !SOA1_SV_AGE_COHORT_INDEX_H
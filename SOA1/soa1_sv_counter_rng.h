@@ -0,0 +1,162 @@
+/* SOA1, individual based STI simulation
+Copyright (C) 2015, RIVM
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+
+/*
+GOAL: A random number generator for which the numbers only depend on a key
+(master seed, stream id) and a position (counter) in the stream. Not on the
+order in which generators are constructed or on which thread uses them. So
+every part of the model (and later every person, relation, ...) can have its
+own stream which gives the same numbers whatever else happens.
+
+INPUT ON CONSTRUCTION: The master seed and a stream id. Use StreamId() to
+combine a purpose (see stream::StreamList) and an entity id (e.g. person id)
+into a stream id.
+
+IMPLEMENTATION: Philox4x32-10 (Salmon et al. 2011, "Parallel random numbers:
+as easy as 1, 2, 3"). The counter (64 bits) and the stream id (64 bits) form
+the 128 bit block which is encrypted with the seed as key. Every block gives
+4 random numbers. Jumping to any position is free (it is just a counter).
+It satisfies the UniformRandomBitGenerator requirements so it can be used with
+the std::..._distribution classes and std::shuffle.
+
+OUTPUT: 32 bit random numbers. One at a time (operator()) or in bulk (Fill,
+no branching per number so the compiler can vectorize it).
+*/
+#ifndef SOA1_SV_COUNTER_RNG_H
+#define SOA1_SV_COUNTER_RNG_H
+#include <cstdint>
+#include <array>
+#include <limits>
+
+namespace soa1 { // soa is the dutch equivalent of sti
+namespace sv {   // sv -> status variables
+namespace stream {
+
+// What a stream of random numbers is used for. Never reorder or remove these,
+// the value is part of the stream id (so changing it changes the results).
+enum StreamList {
+  STATE,               // state.random_number_generator()
+  POPULATE,            // dem::Populate ages
+  DURATION,            // rg::dur::GetDuration
+  MATCHMAKER,          // rg::mm::MatchMaker
+  TRANSMISSION,        // tr::Transmission
+  PROCESS_X_GENERATOR, // Seed of the alje::ProcessXGenerator
+  PERSON,              // Per person (entity id = person id)
+  RELATION,            // Per relation (entity id = relation id)
+  MORTALITY,           // dem::Mortality, per person (entity id = person id)
+  HIV_MORTALITY,       // dem::Mortality, per person (entity id = person id)
+  BIRTHS,              // dem::Births, per day (entity id = day)
+  IMMIGRATION,         // dem::Migration, per day (entity id = day)
+  EMIGRATION           // dem::Migration, per person (entity id = person id)
+}; //!enum StreamList
+} // !namespace stream
+
+inline std::uint64_t StreamId(stream::StreamList purpose, int entity_id = 0) {
+  // Purpose in the high bits, entity in the low bits. So every (purpose,
+  // entity) combination gets its own stream.
+  return (static_cast<std::uint64_t>(purpose) << 32) |
+      static_cast<std::uint32_t>(entity_id);
+}
+
+class CounterRng {
+public:
+  typedef std::uint32_t result_type;
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  inline result_type operator()() {
+    if (buffer_position_ == 4) {
+      buffer_ = Block(counter_);
+      ++counter_;
+      buffer_position_ = 0;
+    }
+    return buffer_[buffer_position_++];
+  }
+
+  void Fill(result_type* first, result_type* last) {
+    // Bulk version of operator(). Use up what is left of the current block
+    // first, so mixing Fill and operator() gives the same numbers as only
+    // using operator().
+    while (first != last && buffer_position_ != 4) {
+      *first++ = buffer_[buffer_position_++];
+    }
+    while (last - first >= 4) {
+      std::array<result_type, 4> block = Block(counter_);
+      ++counter_;
+      for (int i = 0; i < 4; ++i) first[i] = block[i];
+      first += 4;
+    }
+    while (first != last) *first++ = (*this)();
+  }
+
+  // The position in the stream (in blocks of 4 numbers).
+  std::uint64_t counter() const { return counter_; }
+
+  // Seeding with a single value (e.g. by a std::..._distribution user which
+  // wants a std:: style engine) selects stream 0.
+  explicit CounterRng(std::uint64_t seed, std::uint64_t stream_id = 0,
+      std::uint64_t counter = 0) :
+      seed_(seed), stream_id_(stream_id), counter_(counter) {}
+
+  CounterRng() = delete; // We need a seed.
+
+private:
+  std::uint64_t seed_;
+  std::uint64_t stream_id_;
+  std::uint64_t counter_;
+  std::array<result_type, 4> buffer_;
+  int buffer_position_ = 4; // 4 means the buffer is used up.
+
+  static inline void MultiplyHighLow(std::uint32_t a, std::uint32_t b,
+      std::uint32_t& high, std::uint32_t& low) {
+    std::uint64_t product = static_cast<std::uint64_t>(a) * b;
+    high = static_cast<std::uint32_t>(product >> 32);
+    low = static_cast<std::uint32_t>(product);
+  }
+
+  std::array<result_type, 4> Block(std::uint64_t counter) const {
+    // The Philox4x32 constants (see the paper mentioned at the top).
+    const std::uint32_t kMultiplier0 = 0xD2511F53;
+    const std::uint32_t kMultiplier1 = 0xCD9E8D57;
+    const std::uint32_t kWeyl0 = 0x9E3779B9;
+    const std::uint32_t kWeyl1 = 0xBB67AE85;
+
+    std::uint32_t c[4] = {
+      static_cast<std::uint32_t>(counter),
+      static_cast<std::uint32_t>(counter >> 32),
+      static_cast<std::uint32_t>(stream_id_),
+      static_cast<std::uint32_t>(stream_id_ >> 32)};
+    std::uint32_t key0 = static_cast<std::uint32_t>(seed_);
+    std::uint32_t key1 = static_cast<std::uint32_t>(seed_ >> 32);
+
+    for (int round = 0; round < 10; ++round) {
+      std::uint32_t high0, low0, high1, low1;
+      MultiplyHighLow(kMultiplier0, c[0], high0, low0);
+      MultiplyHighLow(kMultiplier1, c[2], high1, low1);
+      std::uint32_t next[4] = {
+        high1 ^ c[1] ^ key0, low1, high0 ^ c[3] ^ key1, low0};
+      for (int i = 0; i < 4; ++i) c[i] = next[i];
+      key0 += kWeyl0;
+      key1 += kWeyl1;
+    }
+    return {{c[0], c[1], c[2], c[3]}};
+  }
+};//!class CounterRng
+}// !namespace sv
+}// !namespace soa1
+#endif// !SOA1_SV_COUNTER_RNG_H
@@ -0,0 +1,90 @@
+/* SOA1, individual based STI simulation
+Copyright (C) 2015, RIVM
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+
+/*
+GOAL: Keep the day on which every person dies without an event per person.
+Persons die at a fixed age, so they die in order of day of birth and nobody
+needs to be found in between.
+
+INPUT: Add(day, person_id) when a person is born, PopDue(day) once a day.
+
+IMPLEMENTATION: One bucket (the persons in order of addition) per day of
+death in a deque, the front bucket is the first day which has not been popped
+yet. A person born today dies later than everyone born before, so births only
+add to the back (Populate adds all over the queue).
+
+OUTPUT: The persons who die on a day (see dem::ev::Deaths).
+
+NOTE: Only for deaths which are known when the person is added. A person who
+has died (been removed) in another way is still in the queue, whoever pops
+needs to check.
+*/
+
+#ifndef SOA1_SV_DEATH_QUEUE_H
+#define SOA1_SV_DEATH_QUEUE_H
+#include <deque>
+#include <vector>
+#include <cassert>
+
+namespace soa1 {
+namespace sv { // sv -> status variables
+
+class DeathQueue {
+public:
+  void Add(int day, int person_id) {
+    assert(day >= first_day_ && "Error in soa1::sv::DeathQueue::Add, the day "
+      "of death has already been popped.");
+    std::size_t index = static_cast<std::size_t>(day - first_day_);
+    if (index >= buckets_.size()) buckets_.resize(index + 1);
+    buckets_[index].push_back(person_id);
+    ++size_;
+  }
+
+  // The persons who die on or before day (that were not popped yet), in
+  // order of day and addition.
+  std::vector<int> PopDue(int day) {
+    std::vector<int> due;
+    while (first_day_ <= day && buckets_.empty() == false) {
+      if (due.empty()) {
+        due.swap(buckets_.front());
+      } else {
+        due.insert(due.end(), buckets_.front().begin(), 
+            buckets_.front().end());
+      }
+      buckets_.pop_front();
+      ++first_day_;
+    }
+    if (first_day_ <= day) first_day_ = day + 1; // Nothing queued that far.
+    size_ -= due.size();
+    return due;
+  }
+
+  std::size_t size() const {return size_;}
+  // The first day which can still be added.
+  int first_day() const {return first_day_;}
+
+  DeathQueue() = default;
+  DeathQueue(const DeathQueue&) = delete;
+  DeathQueue& operator=(const DeathQueue&) = delete;
+
+private:
+  std::deque<std::vector<int>> buckets_; // buckets_[i]: die on first_day_ + i
+  int first_day_ = 0;
+  std::size_t size_ = 0;
+};//!class DeathQueue
+}// !namespace sv
+}// !namespace soa1
+#endif// !SOA1_SV_DEATH_QUEUE_H
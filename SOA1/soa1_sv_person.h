@@ -25,29 +25,48 @@ result in tedious syncing).
 #ifndef SOA1_SV_PERSON_H
 #define SOA1_SV_PERSON_H
 #include <limits>
+#include <tuple>
 // For seeding the stationary process
 #include "alje_rng_seed_generator.h" 
 #include "soa1_rg_start_next_relation_person_time.h"
-#include "soa1_parameters_pack.h"
+#include "soa1_rg_start_relation_start_model.h"
 #include "soa1_sv_person_hiv_status.h"
 #include "soa1_sv_person_gonorrhea_status.h"
+#include "soa1_sv_transmission_tree_log.h" // The index of every STI
 namespace soa1 {
 namespace sv { // sv -> status variables
 class Person {
 public:   
+  // One status per STI, in the order of transmission_tree::Disease.
+  typedef std::tuple<person::HIVStatus, person::GonorrheaStatus> StiStatuses;
+  static_assert(std::tuple_size<StiStatuses>::value == 
+      transmission_tree::N_DISEASES, 
+      "Error in soa1::sv::Person, every disease needs a status.");
+
   const int id() const {return id_;}
   const int day_of_birth() const{return day_of_birth_;}
+  // The status of an STI by its index (tr::sti::X::kIndex).
+  template <int kIndex>
+  inline const typename std::tuple_element<kIndex, StiStatuses>::type& 
+      sti_status() const {
+    return std::get<kIndex>(sti_statuses_);
+  }
+  template <int kIndex>
+  inline typename std::tuple_element<kIndex, StiStatuses>::type& 
+      sti_status() {
+    return std::get<kIndex>(sti_statuses_);
+  }
   inline const soa1::sv::person::HIVStatus& hiv_status() const {
-    return hiv_status_;
+    return sti_status<transmission_tree::DISEASE_HIV>();
   }
   inline sv::person::HIVStatus& hiv_status() {
-    return hiv_status_;
+    return sti_status<transmission_tree::DISEASE_HIV>();
   }
   inline const sv::person::GonorrheaStatus& gonorrhea_status() const {
-    return gonorrhea_status_;
+    return sti_status<transmission_tree::DISEASE_GN>();
   }
   inline sv::person::GonorrheaStatus& gonorrhea_status() {
-    return gonorrhea_status_;
+    return sti_status<transmission_tree::DISEASE_GN>();
   }
   int next_relation_time() {
     int next_relation_person_time = next_relation_person_time_.Get();
@@ -60,19 +79,20 @@ public:
     }
   } // !member function next_relation_time()
 
+  // Everything which is the same for every person is in the relation start
+  // model (owned by the state), a person only refers to it.
   Person(int day_of_birth_supplied,
-        soa1::parameters::ParameterPack par_pack,
+        const rg::start::RelationStartModel& relation_start_model,
         alje::RngSeedGenerator& seed_gen) :
-        next_relation_person_time_(par_pack.relation_generation_start, seed_gen){
+        next_relation_person_time_(relation_start_model, seed_gen){
     day_of_birth_ = day_of_birth_supplied;
   }
 
   Person(int day_of_birth_supplied,
-    soa1::parameters::ParameterPack par_pack,
+    const rg::start::RelationStartModel& relation_start_model,
     alje::RngSeedGenerator& seed_gen,
     alje::ProcessXGenerator& process_x_gen) :
-    next_relation_person_time_(par_pack.relation_generation_start, 
-                               seed_gen, process_x_gen){
+    next_relation_person_time_(relation_start_model, seed_gen, process_x_gen){
     day_of_birth_ = day_of_birth_supplied;
   }
 
@@ -94,8 +114,7 @@ private:
     return id;
   }
   int day_of_birth_;
-  sv::person::HIVStatus hiv_status_;
-  sv::person::GonorrheaStatus gonorrhea_status_;
+  StiStatuses sti_statuses_;
   int id_ = get_unique_id();
   rg::start::NextRelationPersonTime next_relation_person_time_;
 
@@ -53,6 +53,10 @@ public:
     return person_map_.size();
   }
 
+  bool Contains(int personID) const {
+    return person_map_.find(personID) != person_map_.end();
+  }
+
   Person& operator[](const int personID){
     // std::unordered_map::operator[] requires the object in the map to be
     // default constructible (because it will return a default constructed
@@ -20,6 +20,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
 
 #ifndef SOA1_SV_PRIORITY_LIST_H
 #define SOA1_SV_PRIORITY_LIST_H
+#include "soa1_sv_transmission_tree_log.h" // For the number of diseases
 
 namespace soa1{
 namespace sv { // sv -> status variables
@@ -30,10 +31,12 @@ enum PriorityList {
   BIRTHS,
   RELATION_START,
   MATCHMAKING,
+  STI_TRANSMISSION, // All STIs at once (see tr::ev::RelationTransmission)
   RELATION_END,
-  HIV_TRANSMISSION,
-  GN_TRANSMISSION,
-  GN_NATURAL_CURE,
+  // One priority per STI, in the order of transmission_tree::Disease
+  // (tr::sti::X::kPriority).
+  FIRST_STI_TRANSMISSION,
+  GN_NATURAL_CURE = FIRST_STI_TRANSMISSION + transmission_tree::N_DISEASES,
   FIRST = DEATH, // We store a first and last to allow us to loop over
   LAST = GN_NATURAL_CURE
 }; //!enum PriorityList
@@ -17,6 +17,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
 #ifndef SOA1_SV_RELATION_H
 #define SOA1_SV_RELATION_H
 #include <limits>
+#include "soa1_sv_relation_hiv_hazard_clock.h"
+#include "soa1_sv_relation_pending_transmissions.h"
 
 namespace soa1{
 namespace sv{ // sv -> Status Variables
@@ -28,6 +30,14 @@ public:
   const int person2_id() const{return person2_id_;}
   const int time_start() const{return time_start_;}
   const int time_end() const{return time_end_;}
+  // The relation list only hands out const relations (they are the keys of
+  // its index). The clock is not part of any key so it may change.
+  relation::HIVHazardClock& hiv_hazard_clock() const {
+    return hiv_hazard_clock_;
+  }
+  relation::PendingTransmissions& pending_transmissions() const {
+    return pending_transmissions_;
+  }
     
   Relation(int person1_id, int person2_id, int time_start, int time_end) :
     person1_id_(person1_id),
@@ -55,6 +65,8 @@ private:
   const int person2_id_;
   const int time_start_;
   int time_end_; // Can change
+  mutable relation::HIVHazardClock hiv_hazard_clock_;
+  mutable relation::PendingTransmissions pending_transmissions_;
   
 }; // !class Relation
 } // !namespace sv
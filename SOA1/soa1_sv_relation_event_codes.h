@@ -24,14 +24,19 @@ namespace to determine what happened.
 
 #ifndef SOA1_SV_RELATION_EVENT_CODES_H
 #define SOA1_SV_RELATION_EVENT_CODES_H
+#include "soa1_sv_transmission_tree_log.h" // For the number of diseases
 
 namespace soa1{
 namespace sv{ // sv -> status variables
 namespace relation_event_codes{
   enum RelationEventCodes{ 
     END_DUE_TO_DEATH,
-    CANCEL_EV_HIV_TRANSMISSION,
-    CANCEL_EV_GN_TRANSMISSION,
+    CANCEL_EV_STI_TRANSMISSION, // All STIs at once
+    // One code per STI, in the order of transmission_tree::Disease
+    // (tr::sti::X::kCancelCode).
+    CANCEL_EV_FIRST_STI_TRANSMISSION,
+    N_RELATION_EVENT_CODES = 
+        CANCEL_EV_FIRST_STI_TRANSMISSION + transmission_tree::N_DISEASES
   };
 
 }// !namespace soa1
@@ -0,0 +1,51 @@
+/* SOA1, individual based STI simulation
+Copyright (C) 2015, RIVM
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+
+/*
+GOAL: Remember how much of the (unit exponential) hazard of HIV transmission
+in a relation is left. When the rate of transmission changes (someone gets or
+loses gonorrhea) the transmission time is found by continuing with what is
+left instead of drawing a new one. So fewer random numbers are needed and a
+run with a change of rate uses the same random numbers as a run without.
+
+IMPLEMENTATION: The hazard left (budget) is stored together with where it was
+measured: the infected person, who had gonorrhea (which table of
+tr::Transmission was used) and the time since infection. See
+tr::Transmission::GetHIVTransmission.
+
+NOTE: A budget only belongs to the infected person who was infected at the
+time. If someone else is the infected person (or there was no budget yet) a
+new budget is drawn.
+*/
+
+#ifndef SOA1_SV_RELATION_HIV_HAZARD_CLOCK_H
+#define SOA1_SV_RELATION_HIV_HAZARD_CLOCK_H
+
+namespace soa1 {
+namespace sv {
+namespace relation {
+
+struct HIVHazardClock {
+  int infected_person_id = -1;  // -1 -> no budget yet.
+  bool infected_has_gn = false;
+  bool susceptible_has_gn = false;
+  int t_since_infection = 0;    // Where the budget was measured.
+  double budget = 0;            // Hazard left at t_since_infection.
+};//!struct HIVHazardClock
+}// !namespace relation
+}// !namespace sv
+}// !namespace soa1
+#endif// !SOA1_SV_RELATION_HIV_HAZARD_CLOCK_H
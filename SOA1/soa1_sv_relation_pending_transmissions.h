@@ -0,0 +1,49 @@
+/* SOA1, individual based STI simulation
+Copyright (C) 2015, RIVM
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+
+/*
+GOAL: Remember the next transmission of every STI in a relation, so a single
+event (tr::ev::RelationTransmission) can be scheduled at the earliest of them.
+
+IMPLEMENTATION: Per STI (indexed by tr::sti::X::kIndex) the day of the next
+transmission and who gets infected, and the day of the event which is
+currently scheduled for the relation.
+
+NOTE: Only used if parameters::TransmissionEvents::one_event_per_relation.
+*/
+
+#ifndef SOA1_SV_RELATION_PENDING_TRANSMISSIONS_H
+#define SOA1_SV_RELATION_PENDING_TRANSMISSIONS_H
+#include <array>
+
+namespace soa1 {
+namespace sv {
+namespace relation {
+
+struct PendingTransmission {
+  int time_due = -1;             // -1 -> no transmission.
+  int person_to_infect_id = -1;
+};//!struct PendingTransmission
+
+struct PendingTransmissions {
+  static const int kMaxStis = 4; // Raise when adding STIs (see tr::sti).
+  std::array<PendingTransmission, kMaxStis> sti;
+  int event_time_due = -1;       // -1 -> no event scheduled.
+};//!struct PendingTransmissions
+}// !namespace relation
+}// !namespace sv
+}// !namespace soa1
+#endif// !SOA1_SV_RELATION_PENDING_TRANSMISSIONS_H
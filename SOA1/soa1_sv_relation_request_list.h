@@ -1,14 +1,70 @@
+/* SOA1, individual based STI simulation
+Copyright (C) 2015, RIVM
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+
+/*
+GOAL: Collect the relation requests of a single day. People who want a
+relation are found during the RELATION_START priority, but their requests are
+only needed by the matchmaker (MATCHMAKING priority). Collecting them allows
+the durations of all requests of a day to be generated in one go.
+
+IMPLEMENTATION: Two aligned vectors: the requests themselves (without a
+duration yet) and the interrelation time of every request (needed to get the
+duration). See rg_add_relation_request.
+
+NOTE: The order of the requests is the order in which they were added. Keep
+it that way, the durations depend on the order (random numbers).
+*/
+
 #ifndef SOA1_SV_RELATION_REQUEST_LIST
 #define SOA1_SV_RELATION_REQUEST_LIST
+#include <vector>
+
+#include "soa1_rg_mm_relation_request.h"
 
 namespace soa1 { // soa is the dutch equivalent of sti
 namespace sv { // sv -> status variables
 
 class RelationRequestList {
-  
+public:
+  void Add(int person_id, int day_of_birth, int interrelation_time) {
+    rg::mm::RelationRequest rr;
+    rr.person_id = person_id;
+    rr.duration_in_days = -1; // Not known yet.
+    rr.day_of_birth = day_of_birth;
+    requests_.push_back(rr);
+    interrelation_times_.push_back(interrelation_time);
+  }
+
+  std::vector<rg::mm::RelationRequest>& requests() { return requests_; }
+  const std::vector<int>& interrelation_times() const {
+    return interrelation_times_;
+  }
 
+  bool empty() const { return requests_.empty(); }
 
+  void clear() {
+    // Keeps the capacity, so after the first couple of days no more
+    // allocations are needed.
+    requests_.clear();
+    interrelation_times_.clear();
+  }
 
+private:
+  std::vector<rg::mm::RelationRequest> requests_;
+  std::vector<int> interrelation_times_; // Aligned with requests_
 };
 
 }// !namespace sv
@@ -29,18 +29,29 @@ I remember that everything is instantiated in order of declaration.
 #define SOA1_SV_State_H
 
 #include <vector>
+#include <chrono>  // For the time spent in the matchmaker
 #include <iostream> // For debugging
 
 #include "alje_event_manager.h"
 #include "alje_process_x_generator.h"
 #include "alje_rng_seed_generator.h"
+#include "soa1_sv_counter_rng.h"
 #include "soa1_sv_person_list.h"
 #include "soa1_sv_relation_list.h"
+#include "soa1_sv_relation_request_list.h"
+#include "soa1_sv_transmission_update_list.h"
+#include "soa1_sv_transmission_tree_log.h"
+#include "soa1_sv_death_queue.h"
+#include "soa1_sv_age_cohort_index.h"
 #include "soa1_sv_priority_list.h"
 #include "soa1_rg_dur_get_duration.h"
+#include "soa1_rg_start_relation_start_model.h"
+#include "soa1_rg_start_process_x_cache.h"
 #include "soa1_rg_mm_group_handler.h"
 #include "soa1_rg_mm_matchmaker.h"
 #include "soa1_tr_transmission.h"
+#include "soa1_dem_mortality.h"
+#include "soa1_dem_migration.h"
 
 #include "soa1_parameters_pack.h"
 
@@ -57,9 +68,18 @@ public:
   const PersonList& person_list() const {return person_list_;}
   RelationList& relation_list(){return relation_list_;}
   const RelationList& relation_list() const {return relation_list_;}
+  RelationRequestList& relation_request_list() {
+    return relation_request_list_;
+  }
+  TransmissionUpdateList& transmission_update_list() {
+    return transmission_update_list_;
+  }
   const soa1::parameters::ParameterPack& parameter_pack(){
     return parameter_pack_;
   }
+  const soa1::rg::start::RelationStartModel& relation_start_model() const {
+    return relation_start_model_;
+  }
   soa1::rg::dur::GetDuration& get_duration() {return get_duration_;}
   const soa1::rg::dur::GetDuration& get_duration() const {
     return get_duration_;
@@ -68,17 +88,48 @@ public:
   const soa1::rg::mm::MatchMaker& matchmaker() const {return matchmaker_ ;}
   alje::EventManager& event_manager(){return event_manager_;}
   alje::RngSeedGenerator& seed_generator(){return seed_generator_;}
-  std::minstd_rand& random_number_generator(){return random_number_generator_;}
+  CounterRng& random_number_generator(){return random_number_generator_;}
+  // A new generator for the stream of purpose (and entity). The numbers only
+  // depend on the seed, purpose and entity (see sv::CounterRng).
+  CounterRng Stream(stream::StreamList purpose, int entity_id = 0) const {
+    return CounterRng(static_cast<std::uint32_t>(seed_), 
+        StreamId(purpose, entity_id));
+  }
   alje::ProcessXGenerator& process_x_generator(){return process_x_generator_;}
   tr::Transmission& transmission() {return transmission_;}
+  long long& n_short_relations() {return n_short_relations_;}
+  long long& n_events_executed() {return n_events_executed_;}
+  // Time spent in MatchMaker::Get() (see rg::ev::MatchMaking).
+  std::chrono::steady_clock::duration& matchmaker_time() {
+    return matchmaker_time_;
+  }
+  TransmissionTreeLog& transmission_tree_log() {return transmission_tree_log_;}
+  DeathQueue& death_queue() {return death_queue_;}
+  AgeCohortIndex& age_cohort_index() {return age_cohort_index_;}
+  const AgeCohortIndex& age_cohort_index() const {return age_cohort_index_;}
+  const soa1::dem::Mortality& mortality() const {return mortality_;}
+  const soa1::dem::Migration& migration() const {return migration_;}
 
   // Delegate constructor
   State() : State(alje::RngSeedGenerator::get_system_time()) { 
   }
 
-  State(int seed) :
-    parameter_pack_(),// For some reason this seems necessary
+  State(int seed) : State(seed, parameters::ParameterPack()) {
+  }
+
+  // For runs with other parameters than the defaults (e.g. a larger 
+  // population for benchmarking).
+  State(int seed, const parameters::ParameterPack& parameter_pack) :
+    seed_(seed),
+    parameter_pack_(parameter_pack),
+    transmission_tree_log_(parameter_pack_.output.transmission_tree_file),
     seed_generator_(seed),
+    relation_start_model_(parameter_pack_.relation_generation_start),
+    process_x_cache_(parameter_pack_.output.process_x_cache_file_prefix,
+      parameter_pack_.relation_generation_start,
+      relation_start_model_.WarmUpArrivals(),
+      Stream(stream::PROCESS_X_GENERATOR)()
+    ),
     process_x_generator_(
       parameter_pack_.relation_generation_start.stat_process_average / 365.0,
       parameter_pack_.relation_generation_start.weight_average,
@@ -86,40 +137,71 @@ public:
       parameter_pack_.relation_generation_start.weight_long_history,
       parameter_pack_.relation_generation_start.short_decay_rate_days,
       parameter_pack_.relation_generation_start.long_decay_rate_days,
-      parameter_pack_.relation_generation_start.stat_process_n_prearrivals,
-      seed_generator_.Get()
+      process_x_cache_.PreArrivals(relation_start_model_.WarmUpArrivals()),
+      Stream(stream::PROCESS_X_GENERATOR)() // alje needs a seed
     ),
     get_duration_(
       parameter_pack_.relation_generation_duration,
-      seed_generator_
+      Stream(stream::DURATION)
     ),
-    random_number_generator_(seed_generator_.Get()),
-    group_handler_(time_,person_list_,parameter_pack_.matchmaking),
-    matchmaker_(group_handler_,pcm_par_,seed_generator_.Get()),
+    random_number_generator_(Stream(stream::STATE)),
+    group_handler_(time_,parameter_pack_.matchmaking),
+    matchmaker_(group_handler_,pcm_par_,Stream(stream::MATCHMAKER)),
     transmission_(parameter_pack_.sexual_behavior, parameter_pack_.hiv,
         parameter_pack_.gonorrhea,
-        seed_generator_.Get())
-    {} 
+        Stream(stream::TRANSMISSION)),
+    mortality_(parameter_pack_.mortality, static_cast<int>(
+        parameter_pack_.relation_generation_start.sexual_stop * 365)),
+    migration_(parameter_pack_.demographics, static_cast<int>(
+        parameter_pack_.relation_generation_start.sexual_onset * 365),
+      static_cast<int>(
+        parameter_pack_.relation_generation_start.sexual_stop * 365))
+    {
+      // Replaces the (cold) generator by the warmed one of an earlier run or
+      // stores this one for the next run.
+      process_x_cache_.Restore(process_x_generator_);
+    }
 
   State(const State&) = delete;
   State& operator=(const State&) =delete;
 
 
 private:
+  int seed_; // Master seed, everything random is derived from it.
   int time_ = 0;
   int current_priority_ = 0;
   PersonList person_list_;
   RelationList relation_list_;
+  RelationRequestList relation_request_list_; // Requests of today
+  // Relations to update at the end of the priority.
+  TransmissionUpdateList transmission_update_list_;
+  // Relations which were never stored (see rg::AddRelation).
+  long long n_short_relations_ = 0;
+  // Every event counts itself when it is executed (not when it's cancelled).
+  long long n_events_executed_ = 0;
+  std::chrono::steady_clock::duration matchmaker_time_ = 
+      std::chrono::steady_clock::duration::zero();
+  DeathQueue death_queue_; // Persons by day of death (see dem::ev::Deaths)
+  AgeCohortIndex age_cohort_index_; // The person_list by year of birth.
   const parameters::ParameterPack parameter_pack_;
+  TransmissionTreeLog transmission_tree_log_; // Off unless a file is given.
   alje::EventManager event_manager_;
+  // Only for the alje classes which need seeds. Everything else uses a 
+  // Stream() (see sv::CounterRng).
   alje::RngSeedGenerator seed_generator_;
-  std::minstd_rand random_number_generator_;
+  // Shared by all persons (they refer to it), so needs to stay put.
+  const soa1::rg::start::RelationStartModel relation_start_model_;
+  CounterRng random_number_generator_;
+  // Decides the pre-arrivals of the process_x_generator_, so comes first.
+  soa1::rg::start::ProcessXCache<alje::ProcessXGenerator> process_x_cache_;
   alje::ProcessXGenerator process_x_generator_;
   soa1::rg::dur::GetDuration get_duration_;
   soa1::rg::mm::GroupHandler group_handler_;
   soa1::rg::mm::PartnerChoiceParameters pcm_par_; // use default values.
   soa1::rg::mm::MatchMaker matchmaker_;
   soa1::tr::Transmission transmission_;
+  const soa1::dem::Mortality mortality_;
+  const soa1::dem::Migration migration_;
 };
 
 
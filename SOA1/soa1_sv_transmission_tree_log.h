@@ -0,0 +1,125 @@
+/* SOA1, individual based STI simulation
+Copyright (C) 2015, RIVM
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+
+/*
+GOAL: Record who infected whom (the transmission tree), for phylodynamic
+output. Cheap enough to leave on for large runs.
+
+INPUT: One record per transmission (see tr::Transmit).
+
+INPUT ON CONSTRUCTION: The file to write to. An empty name means nothing is
+recorded (enabled() is false, so nobody needs to build a record).
+
+IMPLEMENTATION: The records are fixed size (20 bytes) and are collected in a
+buffer which is written in one go when it is full (and on destruction). The
+file is only appended to, so the records are in order of time.
+
+OUTPUT: A binary file of transmission_tree::Record, see SOA1TransmissionTree
+for reading it (subtrees, cluster sizes).
+
+NOTE: The records are written as they are in memory, so the file has the
+byte order of the machine which wrote it (little endian on x86).
+*/
+
+#ifndef SOA1_SV_TRANSMISSION_TREE_LOG_H
+#define SOA1_SV_TRANSMISSION_TREE_LOG_H
+#include <cstdint>
+#include <cassert>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace soa1 {
+namespace sv { // sv -> status variables
+namespace transmission_tree {
+
+// The disease of a record. tr::sti::X::kIndex refers to these, so a reader of
+// the file only needs this header.
+enum Disease {
+  DISEASE_HIV = 0,
+  DISEASE_GN = 1,
+  N_DISEASES = 2
+};
+
+// The name of a disease for printing, "unknown" for any other number.
+inline const char* DiseaseName(int disease) {
+  static const char* const kNames[N_DISEASES] = {"hiv", "gn"};
+  if (disease < 0 || disease >= N_DISEASES) return "unknown";
+  return kNames[disease];
+}
+
+// Who had what (before the transmission).
+enum Flags {
+  INFECTOR_HIV = 1,
+  INFECTOR_GN = 2,
+  INFECTEE_HIV = 4,
+  INFECTEE_GN = 8
+};
+
+struct Record {
+  std::int32_t infector_id;   // -1 for the initially infected.
+  std::int32_t infectee_id;
+  std::int32_t relation_id;   // -1 for the initially infected.
+  std::int32_t day;
+  std::uint8_t disease;       // Disease (tr::sti::X::kIndex)
+  std::uint8_t infector_stage;// tr::sti::X::Stage
+  std::uint8_t flags;         // Flags
+  std::uint8_t unused;        // Keeps the size at 20 bytes.
+};//!struct Record
+static_assert(sizeof(Record) == 20, "Error in soa1::sv::transmission_tree, "
+  "the record has padding.");
+}// !namespace transmission_tree
+
+class TransmissionTreeLog {
+public:
+  bool enabled() const {return file_.is_open();}
+
+  void Add(const transmission_tree::Record& record) {
+    buffer_.push_back(record);
+    if (buffer_.size() == kBufferSize) Flush();
+  }
+
+  void Flush() {
+    if (buffer_.empty()) return;
+    file_.write(reinterpret_cast<const char*>(buffer_.data()), 
+        buffer_.size() * sizeof(transmission_tree::Record));
+    file_.flush();
+    buffer_.clear();
+  }
+
+  TransmissionTreeLog(const std::string& file_name) {
+    if (file_name.empty()) return;
+    file_.open(file_name, std::ios::binary | std::ios::trunc);
+    assert(file_.is_open() && "Error in soa1::sv::TransmissionTreeLog could "
+      "not open the file.");
+    buffer_.reserve(kBufferSize);
+  }
+
+  ~TransmissionTreeLog() {
+    Flush();
+  }
+
+  TransmissionTreeLog(const TransmissionTreeLog&) = delete;
+  TransmissionTreeLog& operator=(const TransmissionTreeLog&) = delete;
+
+private:
+  static const std::size_t kBufferSize = 4096; // In records (80 kB)
+  std::ofstream file_;
+  std::vector<transmission_tree::Record> buffer_;
+};//!class TransmissionTreeLog
+}// !namespace sv
+}// !namespace soa1
+#endif// !SOA1_SV_TRANSMISSION_TREE_LOG_H
@@ -0,0 +1,85 @@
+/* SOA1, individual based STI simulation
+Copyright (C) 2015, RIVM
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+
+/*
+GOAL: Collect the relations for which the transmission events have to be
+updated (someone got infected or cured, a relation started). Updating them
+right away would update a relation again for every change during a priority
+(e.g. both persons getting infected, or HIV and gonorrhea both changing).
+Collecting them means every (relation, disease) is updated once.
+
+INPUT: Add(relation_id, diseases) whenever a transmission event of that
+relation might have to change. diseases is a combination (|) of
+transmission_update::DiseaseList.
+
+IMPLEMENTATION: The relations in the order they were first added (the order
+of the updates determines the random numbers, so it has to be fixed) and the
+diseases to update per relation. Flushed at the end of every priority, see
+tr::UpdateTransmissionEvents.
+
+OUTPUT: entries() with every relation once. clear() after the updates.
+*/
+
+#ifndef SOA1_SV_TRANSMISSION_UPDATE_LIST_H
+#define SOA1_SV_TRANSMISSION_UPDATE_LIST_H
+#include <vector>
+#include <unordered_map>
+#include "soa1_sv_transmission_tree_log.h" // For the number of diseases
+
+namespace soa1 { // soa is the dutch equivalent of sti
+namespace sv {   // sv -> status variables
+namespace transmission_update {
+// Bit kIndex is the flag of an STI (tr::sti::X::kUpdateFlag).
+enum DiseaseList {
+  HIV = 1 << transmission_tree::DISEASE_HIV,
+  GN = 1 << transmission_tree::DISEASE_GN,
+  ALL = (1 << transmission_tree::N_DISEASES) - 1
+}; //!enum DiseaseList
+} // !namespace transmission_update
+
+class TransmissionUpdateList {
+public:
+  struct Entry {
+    int relation_id;
+    int diseases; // transmission_update::DiseaseList combination.
+  };
+
+  void Add(int relation_id, int diseases) {
+    auto inserted = position_.insert(std::make_pair(relation_id,
+        static_cast<int>(entries_.size())));
+    if (inserted.second) {
+      entries_.push_back(Entry{relation_id, diseases});
+    } else {
+      entries_[inserted.first->second].diseases |= diseases;
+    }
+  }
+
+  const std::vector<Entry>& entries() const { return entries_; }
+  bool empty() const { return entries_.empty(); }
+
+  void clear() {
+    // Keeps the capacity (see sv::RelationRequestList).
+    entries_.clear();
+    position_.clear();
+  }
+
+private:
+  std::vector<Entry> entries_;
+  std::unordered_map<int, int> position_; // relation_id -> index in entries_
+};//!class TransmissionUpdateList
+}// !namespace sv
+}// !namespace soa1
+#endif// !SOA1_SV_TRANSMISSION_UPDATE_LIST_H
@@ -141,7 +141,7 @@ void PersonGetsRelation(int person_id,sv::State& state ){
 }
 
 
-void NewRelation(sv::State& state, int relation_id) {
+void NewRelation(sv::State& state, const sv::Relation& relation) {
   
   // DISABLED WE DON'T WANT INFO. 
    return;
@@ -152,7 +152,7 @@ void NewRelation(sv::State& state, int relation_id) {
   static std::vector<int> person1(5000,0);
   static std::vector<int> person2(5000,0);
 
-  const sv::Relation* rel = state.relation_list().PointerGivenRelationID(relation_id);
+  const sv::Relation* rel = &relation; // Short relations are not stored.
 
   relation_duration_list[n % 5000] = rel->time_end() - state.time();
   person1[n % 5000] = (state.time() - state.person_list()[rel->person1_id()].day_of_birth()) / 365 ;
@@ -0,0 +1,88 @@
+/* SOA1, individual based STI simulation
+Copyright (C) 2015, RIVM
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+
+/*
+GOAL: Decide the transmissions of a relation which is not stored because it is
+short (see rg::AddRelation), so it needs no end event, no transmission update
+and no removal.
+
+INPUT: The state and the (not stored) relation, which has just started.
+
+IMPLEMENTATION: For every STI the transmission is drawn as for a stored
+relation (tr::DrawStiTransmission), which gives no transmission unless it
+happens before the relation ends. Only a transmission gets an event
+(tr::ev::StiTransmission, not listening to the relation, so it checks if both
+are still alive), at the priority at which the transmission events are
+executed.
+
+OUTPUT: void (updated event_list)
+
+NOTES:
+* Nothing is drawn if both persons have the same status (most relations).
+* Changes during the relation are missed: if someone gets infected (through
+  another relation) during it, or the gonorrhea status of one of them changes
+  the HIV rate. For relations of a day or less this hardly matters.
+*/
+
+#ifndef SOA1_TR_ADD_SHORT_RELATION_TRANSMISSIONS_H
+#define SOA1_TR_ADD_SHORT_RELATION_TRANSMISSIONS_H
+#include <memory> // For unique_ptr to event
+#include "alje_event.h"
+#include "soa1_sv_state.h"
+#include "soa1_sv_priority_list.h"
+#include "soa1_sv_relation.h"
+#include "soa1_tr_sti_traits.h"
+#include "soa1_tr_ev_sti_transmission.h"
+#include "soa1_tr_update_sti_transmission_event.h"
+
+namespace soa1 { // Soa is the dutch equivalent of sti
+namespace tr {   // tr -> transmission
+
+namespace { // Unnamed namespace so can only be called from this file.
+inline void AddShortRelationTransmissions(sv::State&, const sv::Relation&, 
+    bool, sti::StiList<>) {
+}
+
+template <typename Sti, typename... Rest>
+inline void AddShortRelationTransmissions(sv::State& state, 
+    const sv::Relation& relation, bool one_event_per_relation, 
+    sti::StiList<Sti, Rest...>) {
+  // Executed at the priority of the transmission events of this STI.
+  int priority = one_event_per_relation ? 
+      static_cast<int>(sv::priority::STI_TRANSMISSION) : Sti::kPriority;
+  int transmission_simulation_time = -1;
+  int person_to_infect_id = -42;  // Initialize to n/a value.
+  if (DrawStiTransmission<Sti>(state, relation, priority, 
+      transmission_simulation_time, person_to_infect_id)) {
+    std::unique_ptr<alje::Event> new_e = 
+        std::make_unique<tr::ev::StiTransmission<Sti>>(state, relation, 
+        person_to_infect_id, transmission_simulation_time, priority, false);
+    state.event_manager().Add(std::move(new_e));
+  }
+  AddShortRelationTransmissions(state, relation, one_event_per_relation,
+      sti::StiList<Rest...>());
+}
+}// !unnamed namespace
+
+inline void AddShortRelationTransmissions(sv::State& state, 
+    const sv::Relation& relation) {
+  AddShortRelationTransmissions(state, relation, 
+      state.parameter_pack().transmission_events.one_event_per_relation,
+      sti::AllStis());
+}// !function AddShortRelationTransmissions
+}// !namespace tr
+}// !namespace soa1
+#endif// !SOA1_TR_ADD_SHORT_RELATION_TRANSMISSIONS_H
@@ -0,0 +1,99 @@
+/* SOA1, individual based STI simulation
+Copyright (C) 2015, RIVM
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+
+/*
+GOAL: Precompute the cumulative hazard of a layer (a rate step function) which
+does not change, so a transmission time can be found without walking the
+layer step by step.
+
+INPUT: A start time (in the coordinates of the layer) and an amount of hazard
+(for a transmission time: a unit exponential random number).
+
+INPUT ON CONSTRUCTION: A layer (see tr::Layer).
+
+IMPLEMENTATION: H(x) = int_{x_0}^{x} m(t) dt is stored at every point x_k of
+the layer. H is piecewise linear so H^-1(H(start) + hazard) is a binary
+search (the last point with H(x_k) <= H(start) + hazard) and an interpolation
+within that step. Left of the first point the rate of the first point is used
+(see tr::Layer), right of the last point the rate of the last point.
+
+OUTPUT: The time from start until the hazard has been accumulated. Or -1 if
+that never happens (the rate drops to 0 for good), as GetTransmissionTime.
+*/
+#ifndef SOA1_TR_CUMULATIVE_HAZARD_H
+#define SOA1_TR_CUMULATIVE_HAZARD_H
+#include <vector>
+#include <algorithm> // For upper_bound
+#include <cassert>
+#include "soa1_tr_layer.h"
+#include "soa1_tr_layer_assert_correct.h"
+
+namespace soa1 { // Soa is the dutch equivalent of sti
+namespace tr {   // tr -> transmission
+
+class CumulativeHazard {
+public:
+  inline double TimeUntil(double start, double hazard) const {
+    double target = H(start) + hazard;
+
+    // The last point at which the cumulative hazard is still <= target.
+    int k = static_cast<int>(std::upper_bound(cumulative_.begin(),
+        cumulative_.end(), target) - cumulative_.begin()) - 1;
+    double x;
+    if (k < 0) { // Left of the first point (rate_[0] > 0, see H()).
+      x = x_[0] + (target - cumulative_[0]) / rate_[0];
+    } else if (rate_[k] == 0) {
+      // A zero rate with the target not reached at the next point can only
+      // be the last step. So the hazard is never accumulated.
+      return -1;
+    } else {
+      x = x_[k] + (target - cumulative_[k]) / rate_[k];
+    }
+    return x - start;
+  }
+
+  // The hazard accumulated between from and to.
+  inline double Between(double from, double to) const {
+    return H(to) - H(from);
+  }
+
+  CumulativeHazard(const Layer& layer) {
+    assert(layer::AssertCorrect(layer));
+    double cumulative = 0;
+    for (int k = 0; k < layer.size(); ++k) {
+      if (k > 0) cumulative += (layer[k].x - layer[k - 1].x) * layer[k - 1].y;
+      x_.push_back(layer[k].x);
+      rate_.push_back(layer[k].y);
+      cumulative_.push_back(cumulative);
+    }
+  }
+
+private:
+  std::vector<double> x_;          // The points of the layer.
+  std::vector<double> rate_;       // Rate after x_[k] (and before x_[0]).
+  std::vector<double> cumulative_; // H(x_[k]), H(x_[0]) = 0.
+
+  // The cumulative hazard at x (negative left of the first point).
+  inline double H(double x) const {
+    int k = static_cast<int>(std::upper_bound(x_.begin(), x_.end(), x) -
+        x_.begin()) - 1;
+    if (k < 0) return (x - x_[0]) * rate_[0];
+    return cumulative_[k] + (x - x_[k]) * rate_[k];
+  }
+};//!class CumulativeHazard
+}// !namespace tr
+}// !namespace soa1
+#endif// !SOA1_TR_CUMULATIVE_HAZARD_H
@@ -0,0 +1,144 @@
+/* SOA1, individual based STI simulation
+Copyright (C) 2015, RIVM
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+
+/*
+GOAL: A single transmission event per relation for all STIs (competing
+hazards). Only used if parameters::TransmissionEvents::one_event_per_relation.
+
+INPUT: depends
+
+INPUT ON CONSTRUCTION: The state, the relation and the day it is due.
+
+IMPLEMENTATION: The next transmission of every STI is kept in the relation
+(sv::relation::PendingTransmissions). Schedule() makes sure there is one event
+at the earliest of them. On execution every STI due today transmits (in the
+order of tr::sti::AllStis) and the event for the remaining STIs is scheduled.
+
+OUTPUT: depends
+
+NOTE:
+* alje events cannot be moved, so an event which is no longer the earliest is
+  cancelled and a new one is added. Schedule() is not called from Execute()
+  with an event scheduled (the event clears it first), so an event never
+  cancels itself.
+* An event is stale if the relation has another event_time_due. Stale events
+  do nothing (this should not happen, but guards against a missed cancel).
+* The transmissions are executed at priority STI_TRANSMISSION, which is before
+  RELATION_END (so the relation still exists on its last day).
+*/
+#ifndef SOA1_TR_EV_RELATION_TRANSMISSION_H
+#define SOA1_TR_EV_RELATION_TRANSMISSION_H
+#include <memory> // For unique_ptr to the next event.
+#include <cassert>
+#include "alje_event.h"
+#include "soa1_sv_state.h"
+#include "soa1_sv_relation.h"
+#include "soa1_sv_relation_pending_transmissions.h"
+#include "soa1_sv_priority_list.h"
+#include "soa1_sv_relation_event_codes.h"
+#include "soa1_tr_sti_traits.h"
+#include "soa1_tr_transmit.h"
+
+namespace soa1 {// SOA is the dutch equivalent of STI
+namespace tr {  // tr -> transmission
+namespace ev {  // ev -> event
+
+class RelationTransmission : public alje::Event {
+public:
+  // Make sure the event of the relation is at the earliest pending
+  // transmission (or that there is no event if there is none).
+  static void Schedule(sv::State& state, const sv::Relation& relation) {
+    sv::relation::PendingTransmissions& pending = 
+        relation.pending_transmissions();
+    int earliest = -1;
+    for (const sv::relation::PendingTransmission& p : pending.sti) {
+      if (p.time_due != -1 && (earliest == -1 || p.time_due < earliest)) {
+        earliest = p.time_due;
+      }
+    }
+    if (earliest == pending.event_time_due) return; // Already scheduled.
+
+    if (pending.event_time_due != -1) {
+      state.event_manager().NotifyChannel2(relation.relation_id(),
+          sv::relation_event_codes::CANCEL_EV_STI_TRANSMISSION);
+    }
+    pending.event_time_due = earliest;
+    if (earliest == -1) return;
+
+    std::unique_ptr<alje::Event> new_e = std::make_unique<RelationTransmission>(
+        state, relation.relation_id(), earliest);
+    state.event_manager().Add(std::move(new_e));
+  }
+
+  virtual void Execute() override {
+    ++state_.n_events_executed();
+    const sv::Relation* relation = 
+        state_.relation_list().PointerGivenRelationID(relation_id_);
+    if (relation == NULL) return; // Ended (the event should be gone).
+
+    sv::relation::PendingTransmissions& pending = 
+        relation->pending_transmissions();
+    if (pending.event_time_due != time_due_) return; // Stale.
+    pending.event_time_due = -1; // This one is done.
+
+    TransmitDue(*relation, sti::AllStis());
+    Schedule(state_, *relation); // The STIs which are not due yet.
+  }
+
+  virtual bool Notify(int track, int number, int extra_info) override {
+    assert(number == relation_id_ && "Error, this event has been called "
+      "but with an incorrect relation_id.");
+    // No transmission after the relation ends, and remove if replaced.
+    return extra_info == sv::relation_event_codes::END_DUE_TO_DEATH ||
+      extra_info == sv::relation_event_codes::CANCEL_EV_STI_TRANSMISSION;
+  }
+
+  RelationTransmission(sv::State& state, int relation_id, int time_due) 
+    : alje::Event(time_due, sv::priority::STI_TRANSMISSION, -1, relation_id),
+      state_(state),
+      relation_id_(relation_id),
+      time_due_(time_due) {
+  }
+
+private:
+  sv::State& state_;
+  int relation_id_;
+  int time_due_;
+
+  // Every STI due today transmits. The person to infect might already have
+  // been infected by another relation today.
+  void TransmitDue(const sv::Relation&, sti::StiList<>) {
+  }
+
+  template <typename Sti, typename... Rest>
+  void TransmitDue(const sv::Relation& relation, sti::StiList<Sti, Rest...>) {
+    sv::relation::PendingTransmission& p = 
+        relation.pending_transmissions().sti[Sti::kIndex];
+    if (p.time_due != -1 && p.time_due <= time_due_) {
+      int person_to_infect_id = p.person_to_infect_id;
+      p = sv::relation::PendingTransmission(); // Done
+      int infector_id = relation.person1_id() == person_to_infect_id ?
+          relation.person2_id() : relation.person1_id();
+      tr::Transmit<Sti>(state_, relation_id_, infector_id,
+          state_.person_list()[person_to_infect_id]);
+    }
+    TransmitDue(relation, sti::StiList<Rest...>());
+  }
+};//!class RelationTransmission
+}// !namespace ev
+}// !namespace tr
+}// !namespace soa1
+#endif// !SOA1_TR_EV_RELATION_TRANSMISSION_H
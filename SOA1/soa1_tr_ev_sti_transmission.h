@@ -14,12 +14,16 @@ GNU General Public License for more details.
 You should have received a copy of the GNU General Public License
 along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
 
-/*soa1_tr_ev_hiv_transmission.h
-GOAL: Being the trigger for people becoming infected.soa1_tr_ev_hiv_transmission.h
+/*
+GOAL: Being the trigger for people becoming infected with an STI.
 
 INPUT: depends
 
-IMPLEMENTATION: calling infect_person to take care of all the infecting details
+INPUT ON CONSTRUCTION (template): The STI (see tr::sti).
+
+IMPLEMENTATION: calling tr::Transmit, which records the transmission and calls
+the infect person function of the STI to take care of all the infecting
+details.
 
 OUTPUT: depends
 
@@ -29,36 +33,38 @@ NOTE:
   change a certain priority group of events which are being executed, which in
   turn is done to avoid self-modifying behavior. This might result in someone
   being infected twice on one day (but by a different person)).
-* This class is very similar to the update_hiv_transmission event. I recommend
-  all changes being made here to be made there as well.
 */
-#ifndef SOA1_TR_EV_HIV_TRANSMISSION_H
-#define SOA1_TR_EV_HIV_TRANSMISSION_H
+#ifndef SOA1_TR_EV_STI_TRANSMISSION_H
+#define SOA1_TR_EV_STI_TRANSMISSION_H
 #include <cassert>
 #include "alje_event.h"
 #include "soa1_sv_state.h"
+#include "soa1_sv_relation.h"
 #include "soa1_sv_priority_list.h"
 #include "soa1_sv_relation_event_codes.h"
-#include "soa1_tr_hiv_infect_person.h"
+#include "soa1_tr_sti_traits.h"
+#include "soa1_tr_transmit.h"
 
 namespace soa1 {// SOA is the dutch equivalent of STI
 namespace tr {  // tr -> transmission
 namespace ev {  // ev -> event
 
-class HIVTransmission : public alje::Event {
+template <typename Sti>
+class StiTransmission : public alje::Event {
 public:
 
   virtual void Execute() override {
-    // person_to_infect_id_ gets infected!
+    ++state_.n_events_executed();
+    // A relation which is not stored does not tell us if one of them died.
+    if (relation_stored_ == false && 
+        (state_.person_list().Contains(infector_id_) == false ||
+        state_.person_list().Contains(person_to_infect_id_) == false)) {
+      return;
+    }
 
+    // person_to_infect_id_ gets infected! (unless already infected)
     sv::Person& person_to_infect = state_.person_list()[person_to_infect_id_];
-
-    // This person might already have been infected by another relation 
-    // (probably in in this timestep as this event would have been removed
-    // otherwise)
-    if (person_to_infect.hiv_status().infected() == false) {
-      tr::HIVInfectPerson(state_, person_to_infect);
-    }
+    tr::Transmit<Sti>(state_, relation_id_, infector_id_, person_to_infect);
   }
 
   virtual bool Notify(int track, int number, int extra_info) {
@@ -69,32 +75,44 @@ public:
       return true;
     }
 
-    // Sometimes a transmission event will be cancelled because the HIV
+    // Sometimes a transmission event will be cancelled because the 
     // transmission event is updated. In this case remove this event. But only
-    // if the model is not currently executing gn transmission events (to avoid
-    // transmission events resulting in removing themself).
-    if (extra_info == sv::relation_event_codes::CANCEL_EV_HIV_TRANSMISSION &&
-      state_.current_priority() != sv::priority::HIV_TRANSMISSION) {
+    // if the model is not currently executing transmission events of this STI
+    // (to avoid transmission events resulting in removing themself).
+    if (extra_info == Sti::kCancelCode &&
+        state_.current_priority() != Sti::kPriority) {
       return true; // Let the eventmanager know it can remove this event.
     }
     return false;
   }
 
-  HIVTransmission(sv::State& state, int relation_id, int person_to_infect_id, 
-      int time_due) 
-    : alje::Event(time_due, sv::priority::HIV_TRANSMISSION, -1, relation_id),
+  // Relations which are not stored (see tr::AddShortRelationTransmissions)
+  // cannot be listened to and can use another priority.
+  StiTransmission(sv::State& state, const sv::Relation& relation,
+      int person_to_infect_id, int time_due, int priority = Sti::kPriority,
+      bool relation_stored = true) 
+    : alje::Event(time_due, priority, -1, 
+        relation_stored ? relation.relation_id() : -1),
       state_(state),
-      relation_id_(relation_id),
-      person_to_infect_id_(person_to_infect_id){
+      relation_id_(relation.relation_id()),
+      infector_id_(relation.person1_id() == person_to_infect_id ? 
+        relation.person2_id() : relation.person1_id()),
+      person_to_infect_id_(person_to_infect_id),
+      relation_stored_(relation_stored){
   }
 
 private:
   sv::State& state_;
   int relation_id_;
+  int infector_id_;
   int person_to_infect_id_;
+  bool relation_stored_;
   
-};//!class Transmission
+};//!class StiTransmission
+
+typedef StiTransmission<sti::HIV> HIVTransmission;
+typedef StiTransmission<sti::GN> GNTransmission;
 }// !namespace ev
 }// !namespace tr
 }// !namespace soa1
-#endif// !SOA1_TR_EV_HIV_TRANSMISSION_H
\ No newline at end of file
+#endif// !SOA1_TR_EV_STI_TRANSMISSION_H
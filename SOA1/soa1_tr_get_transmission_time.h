@@ -30,6 +30,10 @@ IMPLEMENTATION:
   int_{t=0}^T m(t) dt < e
 * Then it is an easy interpolation of (e - int_{t=0}^T m(t) dt)/last_step rate.
 
+For a layer which never changes the cumulative hazard can be precomputed
+(see tr::CumulativeHazard), Get(hazard, start) then draws the same unit
+exponential and looks the time up instead of walking the layer.
+
 OUTPUT: A time in days that transmission will occur. (where layer.x is the
 origin). Or -1 if no transmission will occur.
 
@@ -45,12 +49,14 @@ NOTES:
 #include <cstdio>
 #include "soa1_tr_layer.h"
 #include "soa1_tr_layer_assert_correct.h"
+#include "soa1_tr_cumulative_hazard.h"
+#include "soa1_sv_counter_rng.h"
 
 namespace soa1 { // Soa is the dutch equivalent of sti
 namespace tr {   // tr -> transmission
 class GetTransmissionTime {
 public:
-  inline double Get(tr::Layer layer) { 
+  inline double Get(const tr::Layer& layer) { 
     assert(layer::AssertCorrect(layer));
 
     // The value we want the sum_before_i to be equal to.
@@ -96,12 +102,24 @@ public:
     }
   }// !function Get()
 
-  GetTransmissionTime(std::uint32_t seed) : rng_(seed), unit_exp_dist_(1.0) {}
+  // start is in the coordinates of the cumulative hazard, the returned time
+  // is relative to start.
+  inline double Get(const tr::CumulativeHazard& hazard, double start) {
+    return hazard.TimeUntil(start, DrawHazard());
+  }
+
+  // The unit exponential Get() uses, for callers which keep track of the
+  // hazard themselves.
+  inline double DrawHazard() {
+    return unit_exp_dist_(rng_);
+  }
+
+  GetTransmissionTime(sv::CounterRng rng) : rng_(rng), unit_exp_dist_(1.0) {}
   GetTransmissionTime(const GetTransmissionTime&) = delete;
   GetTransmissionTime& operator=(const GetTransmissionTime&) = delete;
 
 private:
-  std::minstd_rand rng_;
+  sv::CounterRng rng_;
   std::exponential_distribution<> unit_exp_dist_;
 };//!class GetTransmissioNTime
 }// !namespace tr
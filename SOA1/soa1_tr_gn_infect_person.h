@@ -17,7 +17,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
 /*
 GOAL: 
 1.Infect a person with Gonorrhea. This will usually be called by the gn 
-  transmission event (tr::ev::GNTransmission). 
+  transmission event (tr::ev::StiTransmission<tr::sti::GN>). 
 2.Schedule the possible ways a person can get cured of Gonorrhea
 
 INPUT: The simulation state and the person to infect (both by reference).
@@ -25,18 +25,14 @@ INPUT: The simulation state and the person to infect (both by reference).
 IMPLEMENTATION: 
 1. Change the persons GN status (and related variables). Sample a random bool
    variable to determine if it will be symptomatic or asymptomatic.
-2. Find all relations of this person and get a new time for transmission for
-   this relation by calling UpdateGNTransmissionEvent.
+2. Find all relations of this person and mark them for a new time for GN 
+   and HIV (changes due to gn) transmission. The new times are calculated at
+   the end of the priority (see sv::TransmissionUpdateList).
 3. Add natural cure
-4. Recalculate the HIV transmission time (changes due to gn)
 
 OUTPUT: void (updated GB status of a person)
 
 NOTES: 
-* Since UpdateGNTransmissionEvent creates new ev::GNTransmission
-  and ev::GNTransmission calls InfectPerson, we cannot include 
-  UpdateGNTransmission event. This is solved by using a forward declaration
-  a couple of lines down.
 * We use the FindRelationsGivenPersonID function of relationlist (instead of
   using FindRelationIDsGivenPersonID) which will give us temporary pointers.
   but since updateGNStatus does not change relations (only GN) this will
@@ -55,9 +51,6 @@ NOTES:
 namespace soa1 { // Soa is the dutch equivalent of sti
 namespace tr {   // tr -> transmission
 
-// Forward declarations to avoid circular inclusion loop
-void UpdateGNTransmissionEvent(soa1::sv::State&, const soa1::sv::Relation&);
-
 void GNInfectPerson(sv::State& state, sv::Person& person_to_infect) {
   
   // Change person infected_status
@@ -72,8 +65,8 @@ void GNInfectPerson(sv::State& state, sv::Person& person_to_infect) {
   auto relations_infected_person = state.relation_list().
       FindRelationsGivenPersonID(person_to_infect.id());
   for (const sv::Relation* r : relations_infected_person) {
-    tr::UpdateGNTransmissionEvent(state, *r);
-    tr::UpdateHIVTransmissionEvent(state, *r);
+    state.transmission_update_list().Add(r->relation_id(),
+        sv::transmission_update::ALL);
   }
  
   // Set natural cure for the person who was just infected.
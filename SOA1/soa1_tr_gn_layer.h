@@ -42,7 +42,7 @@ namespace tr {   // tr -> transmission
 
 class GNLayer {
 public:
-  tr::Layer Get(const sv::Relation& relation, 
+  const tr::Layer& Get(const sv::Relation& relation, 
       const sv::Person& infected_person, 
       const sv::Person& susceptible_person, int simulation_t) {
     assert(infected_person.gonorrhea_status().infected() == true);
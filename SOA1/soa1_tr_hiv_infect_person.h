@@ -16,22 +16,21 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
 
 /*
 GOAL: Infect a person with HIV. This will usually be called by the hiv 
-transmission event (tr::ev::HIVTransmission).
+transmission event (tr::ev::StiTransmission<tr::sti::HIV>).
 
 INPUT: The simulation state and the person to infect (both by reference).
 
 IMPLEMENTATION: 
-1. Change the persons HIV status (and related variables)
+1. Change the persons HIV status (and related variables, such as the death
+   from HIV)
 2. Find all relations of this person and get a new time for transmission for
-   this relation by calling UpdateHIVTransmissionEvent.
+   this relation by calling UpdateStiTransmissionEvent.
 
 OUTPUT: void (updated hiv status of a person)
 
 NOTES: 
-* Since UpdateHIVTransmissionEvent creates new ev::HIVTransmission
-  and ev::HIVTransmission calls InfectPerson, we cannot include 
-  UpdateHIVTransmission event. This is solved by using a forward declaration
-  a couple of lines down.
+* The relations are only marked for an update of the HIV transmission (see
+  sv::TransmissionUpdateList), which is done at the end of the priority.
 * We use the FindRelationsGivenPersonID function of relationlist (instead of
   using FindRelationIDsGivenPersonID) which will give us temporary pointers.
   but since updateHIVStatus does not change relations (only HIV) this will
@@ -43,21 +42,22 @@ NOTES:
 #ifndef SOA1_TR_HIV_INFECT_PERSON_H
 #define SOA1_TR_HIV_INFECT_PERSON_H
 #include "soa1_sv_state.h"
+#include "soa1_dem_add_death_event.h"
 namespace soa1 { // Soa is the dutch equivalent of sti
 namespace tr {   // tr -> transmission
 
-// Forward declaration to avoid circular loop
-void UpdateHIVTransmissionEvent(soa1::sv::State&,const soa1::sv::Relation&);
-
 void HIVInfectPerson(sv::State& state, sv::Person& person_to_infect) {
   person_to_infect.hiv_status().infected() = true;
   person_to_infect.hiv_status().t_infected() = state.time();
+  dem::AddHIVDeathEvent(state, person_to_infect); // If mortality is enabled.
+  state.age_cohort_index().HIVInfected(person_to_infect);
 
   auto relations_infected_person = state.relation_list().
     FindRelationsGivenPersonID(person_to_infect.id());
 
   for (const sv::Relation* r : relations_infected_person) {
-    tr::UpdateHIVTransmissionEvent(state, *r);
+    state.transmission_update_list().Add(r->relation_id(),
+        sv::transmission_update::HIV);
   }
 }// !function InfectPerson
 
@@ -51,30 +51,44 @@ public:
     assert(susceptible_person.hiv_status().infected() == false);
     assert(infected_person.hiv_status().TSinceInfection(simulation_t) >= 0);
     
+    tr::Layer return_layer = BaseLayer(
+        infected_person.gonorrhea_status().infected(),
+        susceptible_person.gonorrhea_status().infected());
+
+    int t_since_inf=infected_person.hiv_status().TSinceInfection(simulation_t);
+    // Now that we now how long ago this person has been infected we can 
+    // combine this with the general pattern of infectivity. If the person has
+    // been infected for 50 days we should shift this pattern back in time by
+    // 50 days to get the pattern for the person who has been infected for 50
+    // days (hence the * -1)
+    tr::layer::MoveForward(return_layer, -1 * t_since_inf); 
+    return return_layer;
+  }
+
+  // The layer in time since infection (t=0 is the time of infection). Only
+  // depends on who has gonorrhea.
+  tr::Layer BaseLayer(bool infected_has_gn, bool susceptible_has_gn) const {
     tr::Layer return_layer(hiv_base_layer_);   
     // Increase the transmission probability depending on people having
     // gonorrhea.
     double total_multiplier = 1;
-    if (infected_person.gonorrhea_status().infected() == true)
+    if (infected_has_gn == true)
       total_multiplier *= hiv_pos_has_gn_multiplier_;
-    if (susceptible_person.gonorrhea_status().infected() == true)
+    if (susceptible_has_gn == true)
       total_multiplier *= hiv_pos_has_gn_multiplier_;
     for (auto& point : return_layer) {
       point.y *= total_multiplier;
     }
-
-    int t_since_inf=infected_person.hiv_status().TSinceInfection(simulation_t);
-    // Now that we now how long ago this person has been infected we can 
-    // combine this with the general pattern of infectivity. If the person has
-    // been infected for 50 days we should shift this pattern back in time by
-    // 50 days to get the pattern for the person who has been infected for 50
-    // days (hence the * -1)
-    tr::layer::MoveForward(return_layer, -1 * t_since_inf); 
     return return_layer;
   }
+
   HIVLayer(parameters::TransmissionHIV parameters) :
     hiv_pos_has_gn_multiplier_(parameters.hiv_pos_has_gonorrhea_multiplier),
     hiv_neg_has_gn_multiplier_(parameters.hiv_neg_has_gonorrhea_multiplier) {
+    assert(static_cast<int>(parameters.infectivity_over_time.size()) < 
+      tr::Layer::kCapacity && "Error in soa1::tr::HIVLayer->Constructor "
+      "infectivity_over_time has more periods than fit in a tr::Layer (the "
+      "product with the sexual behavior layer needs room as well).");
     for (const std::vector<double>& period : parameters.infectivity_over_time){
       hiv_base_layer_.push_back({period[0], period[1] * parameters.base_rate});
     }
@@ -36,17 +36,55 @@ NOTES:
   (see example)
 * A layer must be sorted according to the time ascending.
 * A layer must have at least 1 point.
+* A layer has a fixed capacity (kCapacity points) which is stored inside the
+  layer itself. Layers are created for every transmission time which is drawn
+  so this avoids a heap allocation for every layer. The layers of this model
+  have a couple of points at most, pushing more than kCapacity points is an
+  error.
 */
 
 #ifndef SOA1_TR_LAYER_H
 #define SOA1_TR_LAYER_H
 
-#include <vector>
+#include <array>
+#include <cassert>
 #include "soa1_tr_coordinate.h"
 
 namespace soa1 { // Soa is the dutch equivalent of sti
 namespace tr {   // tr -> transmission
-typedef std::vector<tr::Coordinate<double>> Layer;
+class Layer {
+public:
+  static const int kCapacity = 16;
+  typedef tr::Coordinate<double>* iterator;
+  typedef const tr::Coordinate<double>* const_iterator;
+
+  int size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  void clear() { size_ = 0; }
+
+  inline void push_back(const tr::Coordinate<double>& coordinate) {
+    assert(size_ < kCapacity && "Error in soa1::tr::Layer->push_back the "
+      "layer is full. Increase kCapacity if layers with more points are "
+      "needed.");
+    points_[size_++] = coordinate;
+  }
+
+  tr::Coordinate<double>& operator[](int i) { return points_[i]; }
+  const tr::Coordinate<double>& operator[](int i) const { return points_[i]; }
+  tr::Coordinate<double>& front() { return points_[0]; }
+  const tr::Coordinate<double>& front() const { return points_[0]; }
+  tr::Coordinate<double>& back() { return points_[size_ - 1]; }
+  const tr::Coordinate<double>& back() const { return points_[size_ - 1]; }
+
+  iterator begin() { return points_.data(); }
+  iterator end() { return points_.data() + size_; }
+  const_iterator begin() const { return points_.data(); }
+  const_iterator end() const { return points_.data() + size_; }
+
+private:
+  std::array<tr::Coordinate<double>, kCapacity> points_;
+  int size_ = 0;
+};//!class Layer
 }// !namespace tr
 }// !namespace soa1
 
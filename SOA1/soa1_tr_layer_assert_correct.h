@@ -23,7 +23,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
 namespace soa1 { // Soa is the dutch equivalent of sti
 namespace tr {   // tr -> transmission
 namespace layer {
-inline bool AssertCorrect(const Layer l) {
+inline bool AssertCorrect(const Layer& l) {
   if (l.size() < 1) return false;// We need at least 1 point.
 
   // Check if x values are sorted ascending (strictly sorted, so no 1,2,2)
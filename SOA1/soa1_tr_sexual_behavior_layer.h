@@ -39,11 +39,16 @@ namespace tr {   // tr -> transmission
 
 class SexualBehaviorLayer {
 public:
-  Layer Get(const sv::Relation& relation, const sv::Person& person1, 
+  const Layer& Get(const sv::Relation& relation, const sv::Person& person1, 
     const sv::Person& person2, int simulation_t) {
     return sb_layer_;
   }
 
+  // The layer is the same for every relation (see top).
+  const Layer& BaseLayer() const {
+    return sb_layer_;
+  }
+
   SexualBehaviorLayer(parameters::TransmissionSexualBehavior parameters) {
     // unprotected anal intercourse rate
     double uai_rate = (1.0 - parameters.condom_use) * parameters.sex_frequency;
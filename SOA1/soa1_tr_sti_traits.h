@@ -0,0 +1,146 @@
+/* SOA1, individual based STI simulation
+Copyright (C) 2015, RIVM
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+
+/*
+GOAL: Describe everything in which the transmission of one STI differs from
+the transmission of another, so the transmission events and the function
+which (re)schedules them are written once (as templates) for every STI. See
+tr::ev::StiTransmission and tr::UpdateStiTransmissionEvent.
+
+IMPLEMENTATION: Every STI is a struct with only static members (a trait).
+It derives from StiCodes<kIndex>, which gives everything that follows from
+its index (its transmission_tree::Disease):
+* kIndex: its place in sv::relation::PendingTransmissions and in
+  sv::Person::StiStatuses.
+* kPriority: the priority of its transmission events
+  (sv::priority::FIRST_STI_TRANSMISSION + kIndex).
+* kCancelCode: the relation event code which cancels its transmission events
+  (sv::relation_event_codes::CANCEL_EV_FIRST_STI_TRANSMISSION + kIndex).
+* kUpdateFlag: its flag in the transmission update list (1 << kIndex).
+* Infected(person): is this person infected?
+The STI itself adds:
+* TransmissionTime(state, relation, infected, susceptible): a random time
+  (from now) until transmission or -1 for never. See tr::Transmission.
+* Infect(state, person): infect the person (progression, cure, ...).
+* Stage(state, infected): the stage of the infection (for the transmission
+  tree, see sv::TransmissionTreeLog).
+The templates are instantiated per STI so everything is resolved at compile
+time (no virtual functions) and inlined.
+
+NOTE: Adding an STI means adding its index to transmission_tree::Disease, its
+status type to sv::Person::StiStatuses, a struct here (and to AllStis) and an
+infect person function. The transmission time can use a layer of
+tr::Transmission or anything else.
+*/
+
+#ifndef SOA1_TR_STI_TRAITS_H
+#define SOA1_TR_STI_TRAITS_H
+#include <vector>
+#include "soa1_sv_state.h"
+#include "soa1_sv_person.h"
+#include "soa1_sv_relation.h"
+#include "soa1_sv_relation_pending_transmissions.h"
+#include "soa1_sv_priority_list.h"
+#include "soa1_sv_relation_event_codes.h"
+#include "soa1_sv_transmission_update_list.h"
+#include "soa1_sv_transmission_tree_log.h"
+#include "soa1_tr_hiv_infect_person.h"
+#include "soa1_tr_gn_infect_person.h"
+
+namespace soa1 { // Soa is the dutch equivalent of sti
+namespace tr {   // tr -> transmission
+namespace sti {
+
+static_assert(sv::transmission_tree::N_DISEASES <= 
+    sv::relation::PendingTransmissions::kMaxStis,
+    "Error in soa1::tr::sti, raise PendingTransmissions::kMaxStis.");
+
+template <int Index>
+struct StiCodes {
+  static const int kIndex = Index;
+  static const sv::priority::PriorityList kPriority = 
+      static_cast<sv::priority::PriorityList>(
+      sv::priority::FIRST_STI_TRANSMISSION + Index);
+  static const sv::relation_event_codes::RelationEventCodes kCancelCode = 
+      static_cast<sv::relation_event_codes::RelationEventCodes>(
+      sv::relation_event_codes::CANCEL_EV_FIRST_STI_TRANSMISSION + Index);
+  static const sv::transmission_update::DiseaseList kUpdateFlag = 
+      static_cast<sv::transmission_update::DiseaseList>(1 << Index);
+
+  static inline bool Infected(const sv::Person& person) {
+    return person.sti_status<Index>().infected();
+  }
+};//!struct StiCodes
+
+struct HIV : StiCodes<sv::transmission_tree::DISEASE_HIV> {
+
+  static inline double TransmissionTime(sv::State& state, 
+      const sv::Relation& relation, const sv::Person& infected_person,
+      const sv::Person& susceptible_person) {
+    // Continues with the hazard left in the relation (see 
+    // sv::relation::HIVHazardClock).
+    return state.transmission().GetHIVTransmission(relation, infected_person,
+        susceptible_person, state.time(), relation.hiv_hazard_clock());
+  }
+
+  static inline void Infect(sv::State& state, sv::Person& person) {
+    tr::HIVInfectPerson(state, person);
+  }
+
+  // The period of parameters::TransmissionHIV::infectivity_over_time.
+  static inline int Stage(sv::State& state, const sv::Person& infected) {
+    int t_since_infection = infected.hiv_status().TSinceInfection(state.time());
+    const std::vector<std::vector<double>>& periods = 
+        state.parameter_pack().hiv.infectivity_over_time;
+    int stage = 0;
+    while (stage + 1 < static_cast<int>(periods.size()) &&
+        periods[stage + 1][0] <= t_since_infection) {
+      ++stage;
+    }
+    return stage;
+  }
+};//!struct HIV
+
+struct GN : StiCodes<sv::transmission_tree::DISEASE_GN> {
+  static inline double TransmissionTime(sv::State& state, 
+      const sv::Relation& relation, const sv::Person& infected_person,
+      const sv::Person& susceptible_person) {
+    return state.transmission().GetGNTransmission(relation, infected_person,
+        susceptible_person, state.time());
+  }
+
+  static inline void Infect(sv::State& state, sv::Person& person) {
+    tr::GNInfectPerson(state, person);
+  }
+
+  // 1 if symptomatic, 0 if not.
+  static inline int Stage(sv::State&, const sv::Person& infected) {
+    return infected.gonorrhea_status().symptomatic() ? 1 : 0;
+  }
+};//!struct GN
+
+// A list of STIs (only used as a type).
+template <typename... Stis> 
+struct StiList {};
+
+// Every STI in the model. Transmission events of a relation are updated in
+// this order (see tr::UpdateTransmissionEvents).
+typedef StiList<GN, HIV> AllStis;
+
+}// !namespace sti
+}// !namespace tr
+}// !namespace soa1
+#endif// !SOA1_TR_STI_TRAITS_H
@@ -25,7 +25,10 @@ IMPLEMENTATION: Since all soa's have some parts in common (the sexual part)
 this class has a general function (at the bottom) which combines the specifics
 of an STI (HIV/Gonorrhoe) with the sexual behavior. Users can call
 Get[putyourstihere]Transmission to get a random transmission time for the next
-time of infection.
+time of infection. For HIV the total layer only depends on who has gonorrhea,
+so its cumulative hazard is precomputed for all 4 combinations and a draw is
+a lookup (see tr::CumulativeHazard). Layers have a fixed capacity and are passed by reference so
+drawing a transmission time does not allocate (see tr::Layer).
 
 OUTPUT: A time until the next infection occurs or -1 if this infection will
 never occur (so 5 means 5 days from now). 
@@ -33,7 +36,6 @@ never occur (so 5 means 5 days from now).
 
 #ifndef SOA1_TR_TRANSMISSION_H
 #define SOA1_TR_TRANSMISSION_H
-#include <cstdint> // For uint32_t
 #include <cassert>
 #include "soa1_tr_layer.h"
 #include "soa1_tr_layer_assert_correct.h"
@@ -42,10 +44,12 @@ never occur (so 5 means 5 days from now).
 #include "soa1_tr_sexual_behavior_layer.h"
 #include "soa1_tr_create_multiplication_layer.h"
 #include "soa1_tr_get_transmission_time.h"
+#include "soa1_tr_cumulative_hazard.h"
 
 #include "soa1_parameters_pack.h" 
 #include "soa1_sv_relation.h" 
 #include "soa1_sv_person.h"
+#include "soa1_sv_counter_rng.h"
 
 namespace soa1 { // Soa is the dutch equivalent of sti
 namespace tr {   // tr -> transmission
@@ -57,31 +61,84 @@ public:
     const sv::Person& infected_person, const sv:: Person& susceptible_person,
     int simulation_time) {
 
-    tr::Layer hiv_layer = hiv_layer_.Get( relation, infected_person, 
-      susceptible_person, simulation_time);
+    assert(infected_person.hiv_status().infected() == true);
+    assert(susceptible_person.hiv_status().infected() == false);
+    int t_since_inf = 
+        infected_person.hiv_status().TSinceInfection(simulation_time);
+    assert(t_since_inf >= 0);
+
+    // The layer only depends on who has gonorrhea, the time since infection
+    // is where we start in it (see hiv_hazard_).
+    const tr::CumulativeHazard& hazard = hiv_hazard_
+        [infected_person.gonorrhea_status().infected() ? 1 : 0]
+        [susceptible_person.gonorrhea_status().infected() ? 1 : 0];
+    return transmission_time_.Get(hazard, t_since_inf);
+  }
 
-    return this->GetTransmissionGivenSTILayer(relation, infected_person,
-      susceptible_person, simulation_time, std::move(hiv_layer));
+  // As above, but continues with the hazard left in the relation (see 
+  // sv::relation::HIVHazardClock) if the infected person already had a 
+  // budget in this relation. The hazard used since then is measured with the
+  // table which was in effect (the rate only changes at updates). Updates the
+  // clock.
+  inline double GetHIVTransmission(const sv::Relation& relation,
+    const sv::Person& infected_person, const sv::Person& susceptible_person,
+    int simulation_time, sv::relation::HIVHazardClock& clock) {
+    assert(infected_person.hiv_status().infected() == true);
+    assert(susceptible_person.hiv_status().infected() == false);
+    int t_since_inf = 
+        infected_person.hiv_status().TSinceInfection(simulation_time);
+    assert(t_since_inf >= clock.t_since_infection);
+
+    double budget;
+    if (clock.infected_person_id == infected_person.id()) {
+      const tr::CumulativeHazard& previous = hiv_hazard_
+          [clock.infected_has_gn ? 1 : 0][clock.susceptible_has_gn ? 1 : 0];
+      budget = clock.budget - 
+          previous.Between(clock.t_since_infection, t_since_inf);
+      // Transmission happens on the day the budget runs out, so at most a
+      // rounding error below 0.
+      if (budget < 0) budget = 0;
+    } else {
+      budget = transmission_time_.DrawHazard();
+    }
+    clock.infected_person_id = infected_person.id();
+    clock.infected_has_gn = infected_person.gonorrhea_status().infected();
+    clock.susceptible_has_gn = susceptible_person.gonorrhea_status().infected();
+    clock.t_since_infection = t_since_inf;
+    clock.budget = budget;
+
+    const tr::CumulativeHazard& hazard = hiv_hazard_
+        [clock.infected_has_gn ? 1 : 0][clock.susceptible_has_gn ? 1 : 0];
+    return hazard.TimeUntil(t_since_inf, budget);
   }
 
   inline double GetGNTransmission(const sv::Relation& relation, 
     const sv::Person& infected_person, const sv::Person& susceptible_person, 
     int simulation_time) {
 
-    tr::Layer gn_layer = gn_layer_.Get(relation, infected_person,
+    const tr::Layer& gn_layer = gn_layer_.Get(relation, infected_person,
       susceptible_person, simulation_time); 
 
     return this->GetTransmissionGivenSTILayer(relation, infected_person, 
-      susceptible_person, simulation_time, std::move(gn_layer));
+      susceptible_person, simulation_time, gn_layer);
   }
 
   Transmission(parameters::TransmissionSexualBehavior sexual_behavior, 
     parameters::TransmissionHIV hiv_parameters, 
-    parameters::TransmissionGonorrhea gn_parameters, std::uint32_t seed) 
+    parameters::TransmissionGonorrhea gn_parameters, sv::CounterRng rng) 
     : sexual_behavior_layer_(sexual_behavior),
       hiv_layer_(hiv_parameters),
       gn_layer_(gn_parameters),
-      transmission_time_(seed) {
+      transmission_time_(rng) {
+    for (int infected_has_gn = 0; infected_has_gn < 2; ++infected_has_gn) {
+      for (int susceptible_has_gn = 0; susceptible_has_gn < 2; 
+          ++susceptible_has_gn) {
+        hiv_hazard_[infected_has_gn].emplace_back(
+            tr::CreateMultiplicationLayer(sexual_behavior_layer_.BaseLayer(),
+            hiv_layer_.BaseLayer(infected_has_gn == 1, 
+            susceptible_has_gn == 1)));
+      }
+    }
   }
 
   Transmission() = delete; // We need parameters!
@@ -92,21 +149,22 @@ private:
   tr::GNLayer gn_layer_;
   // Turns a layer into a time for us:
   tr::GetTransmissionTime transmission_time_;
+  // hiv_hazard_[infected has gn][susceptible has gn] is the cumulative hazard
+  // of the total (sexual behavior * hiv) layer in time since infection. This
+  // works because neither layer depends on anything else (at the moment).
+  std::vector<tr::CumulativeHazard> hiv_hazard_[2];
 
   // Function:
   inline double GetTransmissionGivenSTILayer(const sv::Relation& relation,
     const sv::Person& infected_person, const sv::Person& susceptible_person,
-    int simulation_time, Layer&& sti_layer) {
+    int simulation_time, const Layer& sti_layer) {
     assert(tr::layer::AssertCorrect(sti_layer));
 
-    tr::Layer sb_layer = sexual_behavior_layer_.Get(
+    const tr::Layer& sb_layer = sexual_behavior_layer_.Get(
       relation, infected_person, susceptible_person, simulation_time);
     assert(tr::layer::AssertCorrect(sb_layer));
 
-    std::vector<tr::Layer> sb_and_sti{
-      std::move(sb_layer),std::move(sti_layer)
-    };
-    tr::Layer total_layer = tr::CreateMultiplicationLayer(sb_and_sti);
+    tr::Layer total_layer = tr::CreateMultiplicationLayer(sb_layer, sti_layer);
     assert(tr::layer::AssertCorrect(total_layer));
 
     return transmission_time_.Get(total_layer);
@@ -0,0 +1,86 @@
+/* SOA1, individual based STI simulation
+Copyright (C) 2015, RIVM
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+
+/*
+GOAL: The actual transmission of an STI from one person to another, shared by
+all transmission events. 
+
+INPUT: The state, the relation, the infector and the person to infect. The
+infector and relation are -1 for the persons infected at the start.
+
+INPUT ON CONSTRUCTION (template): The STI (see tr::sti).
+
+IMPLEMENTATION: 
+1. Nothing happens if the person is already infected (by another relation,
+   probably in this timestep as the event would have been removed otherwise).
+2. Record the transmission (if the transmission tree is recorded, see 
+   sv::TransmissionTreeLog). 
+3. Infect the person.
+
+OUTPUT: void (infected person)
+*/
+
+#ifndef SOA1_TR_TRANSMIT_H
+#define SOA1_TR_TRANSMIT_H
+#include <cstdint>
+#include "soa1_sv_state.h"
+#include "soa1_sv_person.h"
+#include "soa1_sv_transmission_tree_log.h"
+#include "soa1_tr_sti_traits.h"
+
+namespace soa1 { // Soa is the dutch equivalent of sti
+namespace tr {   // tr -> transmission
+
+template <typename Sti>
+inline void Transmit(sv::State& state, int relation_id, int infector_id,
+    sv::Person& person_to_infect) {
+  if (Sti::Infected(person_to_infect)) return;
+
+  sv::TransmissionTreeLog& log = state.transmission_tree_log();
+  if (log.enabled()) {
+    namespace tt = sv::transmission_tree;
+    tt::Record record;
+    record.infector_id = infector_id;
+    record.infectee_id = person_to_infect.id();
+    record.relation_id = relation_id;
+    record.day = state.time();
+    record.disease = Sti::kIndex;
+    record.infector_stage = 0;
+    record.flags = 0;
+    record.unused = 0;
+    if (infector_id != -1) {
+      const sv::Person& infector = state.person_list()[infector_id];
+      record.infector_stage = 
+          static_cast<std::uint8_t>(Sti::Stage(state, infector));
+      if (infector.hiv_status().infected()) record.flags |= tt::INFECTOR_HIV;
+      if (infector.gonorrhea_status().infected()) {
+        record.flags |= tt::INFECTOR_GN;
+      }
+    }
+    if (person_to_infect.hiv_status().infected()) {
+      record.flags |= tt::INFECTEE_HIV;
+    }
+    if (person_to_infect.gonorrhea_status().infected()) {
+      record.flags |= tt::INFECTEE_GN;
+    }
+    log.Add(record);
+  }
+
+  Sti::Infect(state, person_to_infect);
+}// !function Transmit
+}// !namespace tr
+}// !namespace soa1
+#endif// !SOA1_TR_TRANSMIT_H
@@ -0,0 +1,63 @@
+/* SOA1, individual based STI simulation
+Copyright (C) 2015, RIVM
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+
+/*
+GOAL: The counterpart of tr::UpdateStiTransmissionEvent if there is one
+transmission event per relation for all STIs (see
+tr::ev::RelationTransmission).
+
+INPUT: The state and the relation for which to update.
+
+INPUT ON CONSTRUCTION (template): The STI (see tr::sti).
+
+IMPLEMENTATION:
+1. Draw the next transmission of the STI (as tr::UpdateStiTransmissionEvent)
+   and store it in the relation (replacing the previous one).
+2. Move the event of the relation to the earliest pending transmission.
+
+OUTPUT: void (updated relation and event_list)
+*/
+
+#ifndef SOA1_TR_UPDATE_STI_PENDING_TRANSMISSION_H
+#define SOA1_TR_UPDATE_STI_PENDING_TRANSMISSION_H
+#include "soa1_sv_state.h"
+#include "soa1_sv_priority_list.h"
+#include "soa1_sv_relation.h"
+#include "soa1_sv_relation_pending_transmissions.h"
+#include "soa1_tr_sti_traits.h"
+#include "soa1_tr_update_sti_transmission_event.h"
+#include "soa1_tr_ev_relation_transmission.h"
+
+namespace soa1 { // Soa is the dutch equivalent of sti
+namespace tr {   // tr -> transmission
+
+template <typename Sti>
+inline void UpdateStiPendingTransmission(sv::State& state, 
+    const sv::Relation& relation) {
+  sv::relation::PendingTransmission drawn; // None, unless drawn below.
+  int time_due = -1;
+  int person_to_infect_id = -42; // Initialize to n/a value.
+  if (DrawStiTransmission<Sti>(state, relation, 
+      sv::priority::STI_TRANSMISSION, time_due, person_to_infect_id)) {
+    drawn.time_due = time_due;
+    drawn.person_to_infect_id = person_to_infect_id;
+  }
+  relation.pending_transmissions().sti[Sti::kIndex] = drawn;
+  ev::RelationTransmission::Schedule(state, relation);
+}// !function UpdateStiPendingTransmission
+}// !namespace tr
+}// !namespace soa1
+#endif// !SOA1_TR_UPDATE_STI_PENDING_TRANSMISSION_H
@@ -16,30 +16,33 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
 
 /*
 GOAL: Provide a single function which can be called if for some reason we want
-to update the transmission of gonorrhea in a relation. 
+to update the transmission of an STI in a relation. 
 
-INPUT: The state,  The relation for which to update and the reason for which
-to update. This reason is in some cases needed to determine the exact control
-flow. (reasons can be found in soa1::sv::relation_event_codes).
+INPUT: The state and the relation for which to update.
+
+INPUT ON CONSTRUCTION (template): The STI (see tr::sti).
 
 IMPLEMENTATION: 
 1. Cancel all/the previous relation for this relation.
-2. Schedule a new event.
+2. Schedule a new event (if one person is infected and the other is not and
+   transmission happens before the relation ends). Drawing the day is a
+   separate function (DrawStiTransmission) as it is shared with
+   tr::UpdateStiPendingTransmission.
 
 OUTPUT: void (updated event_list)
 
 NOTES:
 * Since we are prescheduling there is no loss of accuracy if we just cancel the
-  previous event and calculate a new event.
+  previous event and calculate a new event. alje events cannot be moved, so
+  the event is always replaced (HIV continues the time rather than redrawing
+  it, see sv::relation::HIVHazardClock).
 * Cancelling all/the previous relation will only work for timesteps which are
   not currently being excecuted (in order to prevent weird loops, e.g. events
   removing themselves before they have been fully executed).
-* This class is very similar to the update_hiv_transmission event. I recommend
-  all changes being made here to be made there as well.
 */
 
-#ifndef SOA1_TR_UPDATE_GN_TRANSMISSION_EVENT_H
-#define SOA1_TR_UPDATE_GN_TRANSMISSION_EVENT_H
+#ifndef SOA1_TR_UPDATE_STI_TRANSMISSION_EVENT_H
+#define SOA1_TR_UPDATE_STI_TRANSMISSION_EVENT_H
 #include <memory> // For unique_ptr to event
 #include <cassert>
 #include "alje_event.h"
@@ -47,49 +50,47 @@ NOTES:
 #include "soa1_sv_relation_event_codes.h" // For notifying channel 2.
 #include "soa1_sv_person.h"
 #include "soa1_sv_relation.h"
-#include "soa1_tr_ev_gn_transmission.h"
+#include "soa1_tr_sti_traits.h"
+#include "soa1_tr_ev_sti_transmission.h"
 
 namespace soa1 { // Soa is the dutch equivalent of sti
 namespace tr {   // tr -> transmission
 
-inline void UpdateGNTransmissionEvent(sv::State& state, 
-    const sv::Relation& relation) {
-
-  // Remove previous transmission events
-  state.event_manager().NotifyChannel2(relation.relation_id(),
-        sv::relation_event_codes::CANCEL_EV_GN_TRANSMISSION);
+// Draw the next transmission of Sti in the relation, for transmission events
+// executed at transmission_priority. Returns false if there is none (before
+// the relation ends), otherwise the day and who gets infected.
+template <typename Sti>
+inline bool DrawStiTransmission(sv::State& state, 
+    const sv::Relation& relation, int transmission_priority,
+    int& transmission_simulation_time, int& person_to_infect_id) {
 
   const sv::Person& person1 = state.person_list()[relation.person1_id()];
   const sv::Person& person2 = state.person_list()[relation.person2_id()];
 
   double transmission_time_from_now = -1; 
-  int person_to_infect_id = -42;  // Initialize to n/a value.
   // Serodiscordant?
-  if (person1.gonorrhea_status().infected() 
-      !=person2.gonorrhea_status().infected()){
+  if (Sti::Infected(person1) != Sti::Infected(person2)) {
     // Figure out which person is infected and get a random transmission time,
     // that function requires the first person to be infected, hence the "if".
-    if (person1.gonorrhea_status().infected() == true) {
-      transmission_time_from_now = state.transmission().GetGNTransmission(
-          relation, person1, person2, state.time());
+    if (Sti::Infected(person1) == true) {
+      transmission_time_from_now = 
+          Sti::TransmissionTime(state, relation, person1, person2);
       person_to_infect_id = person2.id();
     } else {
-      transmission_time_from_now = state.transmission().GetGNTransmission(
-        relation, person2, person1, state.time());
+      transmission_time_from_now = 
+          Sti::TransmissionTime(state, relation, person2, person1);
       person_to_infect_id = person1.id();
     }
   } else {  // Serocordant ->
-    return; // No Gonorrhea transmission.
+    return false; // No transmission.
   }
 
   if (transmission_time_from_now == -1) {
-    // Apparently the Transmission->GetGNTransmission() returned -1 (no
-    // transmission). 
-    return; // So no Gonorrhea transmission
+    return false; // Sti::TransmissionTime returned -1, so no transmission.
   }
 
   if (transmission_time_from_now + state.time() > relation.time_end()) {
-    return; // Too late, not interesting.
+    return false; // Too late, not interesting.
   }
   
   // When scheduling transmission we need to know if it is still possible to
@@ -97,23 +98,38 @@ inline void UpdateGNTransmissionEvent(sv::State& state,
   // be executed this timestep). If this is not the case we set the next 
   // timestep to be 0.
   int just_infected_mod = 0;
-  if (state.current_priority() >= sv::priority::GN_TRANSMISSION)
+  if (state.current_priority() >= transmission_priority)
     just_infected_mod = 1;
   // Static_cast rounds down.
-  int transmission_simulation_time = state.time() +  
+  transmission_simulation_time = state.time() +  
       static_cast<int>(transmission_time_from_now) +  just_infected_mod;
 
-  assert(transmission_simulation_time >= state.time() && "Error a gonorrhea"
+  assert(transmission_simulation_time >= state.time() && "Error a "
     "transmission event has been scheduled back in time");
+  return true;
+}// !function DrawStiTransmission
+
+template <typename Sti>
+inline void UpdateStiTransmissionEvent(sv::State& state, 
+    const sv::Relation& relation) {
+
+  // Remove previous transmission events
+  state.event_manager().NotifyChannel2(relation.relation_id(), 
+      Sti::kCancelCode);
+
+  int transmission_simulation_time = -1;
+  int person_to_infect_id = -42;  // Initialize to n/a value.
+  if (DrawStiTransmission<Sti>(state, relation, Sti::kPriority,
+      transmission_simulation_time, person_to_infect_id) == false) {
+    return;
+  }
 
   std::unique_ptr<alje::Event> new_e = 
-      std::make_unique<tr::ev::GNTransmission>(
-      state, relation.relation_id(), person_to_infect_id, 
-      transmission_simulation_time);
+      std::make_unique<tr::ev::StiTransmission<Sti>>(
+      state, relation, person_to_infect_id, transmission_simulation_time);
  
   state.event_manager().Add(std::move(new_e));
- 
-}// function UpdateGNTransmissionEvent
+}// !function UpdateStiTransmissionEvent
 }// !namespace tr
 }// !namespace soa1
-#endif// !SOA1_TR_UPDATE_GN_TRANSMISSION_EVENT_H
\ No newline at end of file
+#endif// !SOA1_TR_UPDATE_STI_TRANSMISSION_EVENT_H
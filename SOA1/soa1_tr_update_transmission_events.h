@@ -0,0 +1,83 @@
+/* SOA1, individual based STI simulation
+Copyright (C) 2015, RIVM
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+
+/*
+GOAL: Update the transmission events of every relation in the state's
+transmission update list (see sv::TransmissionUpdateList).
+
+INPUT: The state.
+
+IMPLEMENTATION: Called at the end of every priority (see Simulation). Every
+relation is updated once per disease, in the order in which the relations
+were added to the list (and per relation in the order of tr::sti::AllStis).
+Relations which have ended since are skipped. Depending on the parameters
+every STI has its own events (tr::UpdateStiTransmissionEvent) or there is one
+event per relation (tr::UpdateStiPendingTransmission).
+
+OUTPUT: void (updated event list, empty transmission update list)
+*/
+
+#ifndef SOA1_TR_UPDATE_TRANSMISSION_EVENTS_H
+#define SOA1_TR_UPDATE_TRANSMISSION_EVENTS_H
+#include "soa1_sv_state.h"
+#include "soa1_sv_relation.h"
+#include "soa1_sv_transmission_update_list.h"
+#include "soa1_tr_sti_traits.h"
+#include "soa1_tr_update_sti_transmission_event.h"
+#include "soa1_tr_update_sti_pending_transmission.h"
+
+namespace soa1 { // Soa is the dutch equivalent of sti
+namespace tr {   // tr -> transmission
+
+namespace { // Unnamed namespace so can only be called from this file.
+// Update the STIs of the list which are flagged in diseases, one at a time.
+inline void UpdateFlaggedStis(sv::State&, const sv::Relation&, int, bool,
+    sti::StiList<>) {
+}
+
+template <typename Sti, typename... Rest>
+inline void UpdateFlaggedStis(sv::State& state, const sv::Relation& relation,
+    int diseases, bool one_event_per_relation, sti::StiList<Sti, Rest...>) {
+  if (diseases & Sti::kUpdateFlag) {
+    if (one_event_per_relation) {
+      tr::UpdateStiPendingTransmission<Sti>(state, relation);
+    } else {
+      tr::UpdateStiTransmissionEvent<Sti>(state, relation);
+    }
+  }
+  UpdateFlaggedStis(state, relation, diseases, one_event_per_relation,
+      sti::StiList<Rest...>());
+}
+}// !unnamed namespace
+
+inline void UpdateTransmissionEvents(sv::State& state) {
+  sv::TransmissionUpdateList& list = state.transmission_update_list();
+  if (list.empty()) return;
+  bool one_event_per_relation = 
+      state.parameter_pack().transmission_events.one_event_per_relation;
+
+  for (const sv::TransmissionUpdateList::Entry& entry : list.entries()) {
+    const sv::Relation* relation = 
+        state.relation_list().PointerGivenRelationID(entry.relation_id);
+    if (relation == NULL) continue; // Relation has ended.
+    UpdateFlaggedStis(state, *relation, entry.diseases, 
+        one_event_per_relation, sti::AllStis());
+  }
+  list.clear();
+}// !function UpdateTransmissionEvents
+}// !namespace tr
+}// !namespace soa1
+#endif// !SOA1_TR_UPDATE_TRANSMISSION_EVENTS_H
@@ -0,0 +1,147 @@
+/* SOA1, individual based STI simulation
+Copyright (C) 2015, RIVM
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+
+/*
+GOAL: Find out how the simulation scales with the population size. The same
+simulation (fixed seed) is run at a number of multiples of the default
+population for a fixed number of simulated years.
+
+INPUT: (command line) SOA1Benchmark [years] [scale ...]
+  years: simulated years per run (default 5).
+  scale: multiples of the default population (default 1 10 100).
+
+IMPLEMENTATION: Every run gets the default parameters with the initial
+population and the initially infected multiplied by the scale. The time of
+every priority is measured separately. The time in MatchMaker::Get() is
+measured by the MatchMaking event itself (see sv::State::matchmaker_time), so
+it does not include handing in the requests or adding the relations. Every
+event counts itself when it is executed (see Simulation::ExecutePriority).
+Creating the population is timed separately and is not part of the time per
+year.
+
+OUTPUT: One row per scale with
+* populate_s: seconds to create the initial population.
+* s_per_year: wall time per simulated year.
+* events_per_s: events executed per second of wall time.
+* relations_per_s: relations formed per second of wall time.
+* mm_share: part of the time spent in MatchMaker::Get().
+* matchmaking_priority_share: part of the time spent in the MATCHMAKING
+  priority (MatchMaker::Get() and scheduling the new relations).
+* peak_rss_mb: peak resident memory of the process so far. Run the scales
+  from small to large, otherwise this is the peak of an earlier (larger) run.
+*/
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <memory>
+#include <cstdlib>
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+#include "soa1_simulation.h"
+
+namespace {
+const int kSeed = 12345; // Fixed, so every run simulates the same thing.
+
+double PeakResidentSetMegaBytes() {
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS counters;
+  GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+  return counters.PeakWorkingSetSize / (1024.0 * 1024.0);
+#else
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return usage.ru_maxrss / (1024.0 * 1024.0); // In bytes
+#else
+  return usage.ru_maxrss / 1024.0; // In kilobytes
+#endif
+#endif
+}
+
+void RunScale(int scale, int years) {
+  typedef std::chrono::steady_clock Clock;
+  typedef std::chrono::duration<double> Seconds;
+
+  soa1::parameters::ParameterPack parameter_pack;
+  parameter_pack.demographics.initial_population *= scale;
+  parameter_pack.hiv.initial_n_infected *= scale;
+  parameter_pack.gonorrhea.initial_n_infected *= scale;
+  // The state is big, so keep it off the stack.
+  std::unique_ptr<soa1::Simulation> simulation(
+      new soa1::Simulation(kSeed, parameter_pack));
+
+  Clock::time_point start = Clock::now();
+  simulation->Initialize();
+  Seconds populate_time = Clock::now() - start;
+
+  std::vector<Clock::duration> priority_time(soa1::sv::priority::LAST + 1);
+  for (int t = 0; t < 365 * years; ++t) {
+    for (int p = soa1::sv::priority::FIRST; p <= soa1::sv::priority::LAST;
+        ++p) {
+      Clock::time_point priority_start = Clock::now();
+      simulation->ExecutePriority(t, p);
+      priority_time[p] += Clock::now() - priority_start;
+    }
+  }
+
+  Clock::duration total_time = Clock::duration::zero();
+  for (Clock::duration d : priority_time) total_time += d;
+  double total_seconds = Seconds(total_time).count();
+  double mm_share = Seconds(simulation->state().matchmaker_time()).count() /
+      total_seconds;
+  double matchmaking_priority_share = 
+      Seconds(priority_time[soa1::sv::priority::MATCHMAKING]).count() /
+      total_seconds;
+  long long n_events = 0;
+  for (int p = soa1::sv::priority::FIRST; p <= soa1::sv::priority::LAST; ++p) {
+    n_events += simulation->n_events_executed(p);
+  }
+  long long n_relations =
+      simulation->state().matchmaker().NumberOfRelationsScheduled();
+
+  std::cout << scale << "\t"
+    << parameter_pack.demographics.initial_population << "\t"
+    << years << "\t"
+    << populate_time.count() << "\t"
+    << total_seconds / years << "\t"
+    << n_events / total_seconds << "\t"
+    << n_relations / total_seconds << "\t"
+    << mm_share << "\t"
+    << matchmaking_priority_share << "\t"
+    << PeakResidentSetMegaBytes() << std::endl;
+}
+} // !namespace
+
+int main(int argc, char* argv[]) {
+  int years = argc > 1 ? std::atoi(argv[1]) : 5;
+  std::vector<int> scales;
+  for (int i = 2; i < argc; ++i) scales.push_back(std::atoi(argv[i]));
+  if (scales.empty()) scales = {1, 10, 100};
+
+  std::cout << std::fixed << std::setprecision(3)
+    << "scale\tpersons\tyears\tpopulate_s\ts_per_year\tevents_per_s\t"
+       "relations_per_s\tmm_share\tmatchmaking_priority_share\t"
+       "peak_rss_mb\n";
+  for (int scale : scales) RunScale(scale, years);
+  return 0;
+}
@@ -0,0 +1,340 @@
+/* SOA1, individual based STI simulation
+Copyright (C) 2015, RIVM
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+
+/*
+GOAL: Time the kernels which dominate a simulation on their own, so a
+proposed optimization of one of them can be compared with the current code
+without running (and timing) whole simulations.
+
+INPUT: (command line) SOA1MicroBenchmark [kernel_filter]
+  kernel_filter: only run the kernels whose name contains this text.
+
+IMPLEMENTATION: The inputs are captured from a populated state with the
+default parameter pack (fixed seed): the persons, their relation requests
+(interrelation times from their own relation start processes, durations from
+GetDuration) and the group sizes these requests give. Every case is run
+kRepetitions times, the body of a case returns how many operations it did.
+
+Kernels (case -> what differs):
+* link_handler_cycle: SortByLinks, Add, SortByValue and schedule until no
+  positive link is left (as MatchMaker::Get). case -> requests per day.
+* partner_choice_matrix_get: PartnerChoiceMatrix::Get. case -> msm hack.
+* get_duration: GetDuration::Get. case -> batch size.
+* next_relation_person_time: NextRelationPersonTime::Get (through Person).
+  case -> whole sexual life of a newborn or catching up to t = 0 at age 50
+  (what Populate does).
+* hiv_transmission: Transmission::GetHIVTransmission. case -> days since
+  the infected person got infected.
+* create_multiplication_layer: CreateMultiplicationLayer of the sexual
+  behavior and HIV layer. case -> as hiv_transmission.
+* relation_list: insert, find (per person) and remove n relations. case -> n.
+* person_list_lookup: PersonList::operator[]. case -> in id order or in a
+  random order.
+
+OUTPUT: CSV on std::cout, one line per case:
+  kernel,case,ops_per_repetition,repetitions,ns_per_op_min,ns_per_op_median
+A checksum of the results (so the compiler cannot remove the work) goes to
+std::cerr.
+*/
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <random>
+#include <limits>
+
+#include "soa1_parameters_pack.h"
+#include "soa1_sv_state.h"
+#include "soa1_sv_person.h"
+#include "soa1_sv_person_list.h"
+#include "soa1_sv_relation.h"
+#include "soa1_sv_relation_list.h"
+#include "soa1_sv_counter_rng.h"
+#include "soa1_dem_populate.h"
+#include "soa1_rg_mm_relation_request.h"
+#include "soa1_rg_mm_group_handler.h"
+#include "soa1_rg_mm_link_handler.h"
+#include "soa1_rg_mm_partner_choice_matrix.h"
+#include "soa1_tr_transmission.h"
+#include "soa1_tr_hiv_layer.h"
+#include "soa1_tr_sexual_behavior_layer.h"
+#include "soa1_tr_create_multiplication_layer.h"
+
+namespace {
+const int kSeed = 12345;
+const int kRepetitions = 7;
+const int kMaxRequests = 100000; // Largest number of requests in a case.
+
+std::string kernel_filter;
+double checksum = 0; // See top (output).
+
+// Runs body kRepetitions times and prints a line (see top). Body returns the
+// number of operations it did.
+template <typename Body>
+void Run(const std::string& kernel, const std::string& case_name, Body body) {
+  if (kernel.find(kernel_filter) == std::string::npos) return;
+  typedef std::chrono::steady_clock Clock;
+  std::vector<double> ns_per_op;
+  long long ops = 0;
+  for (int r = 0; r < kRepetitions; ++r) {
+    Clock::time_point start = Clock::now();
+    ops = body();
+    double ns = std::chrono::duration<double, std::nano>(
+        Clock::now() - start).count();
+    ns_per_op.push_back(ns / (ops > 0 ? ops : 1));
+  }
+  std::sort(ns_per_op.begin(), ns_per_op.end());
+  std::cout << kernel << "," << case_name << "," << ops << ","
+    << kRepetitions << "," << ns_per_op.front() << ","
+    << ns_per_op[kRepetitions / 2] << std::endl;
+}
+
+// The relation requests of a (long) day of the default model. See top.
+struct Workload {
+  std::vector<soa1::rg::mm::RelationRequest> requests;
+  std::vector<int> interrelation_times; // Aligned with requests.
+};
+
+Workload CaptureWorkload(soa1::sv::State& state,
+    const std::vector<int>& person_ids) {
+  Workload workload;
+  soa1::sv::CounterRng rng(kSeed, 1);
+  std::uniform_int_distribution<int> pick(0,
+      static_cast<int>(person_ids.size()) - 1);
+  const int never = std::numeric_limits<int>::max();
+  for (int attempt = 0; attempt < 100 * kMaxRequests &&
+      static_cast<int>(workload.requests.size()) < kMaxRequests; ++attempt) {
+    soa1::sv::Person& person = state.person_list()[person_ids[pick(rng)]];
+    int t_relation = person.next_relation_time();
+    int t_next_relation = person.next_relation_time();
+    if (t_relation == never || t_next_relation == never) continue;
+    soa1::rg::mm::RelationRequest request;
+    request.person_id = person.id();
+    request.day_of_birth = person.day_of_birth();
+    request.duration_in_days = -1;
+    workload.requests.push_back(request);
+    workload.interrelation_times.push_back(t_next_relation - t_relation);
+  }
+  std::vector<int> durations =
+      state.get_duration().Get(workload.interrelation_times);
+  for (int i = 0; i < static_cast<int>(durations.size()); ++i) {
+    workload.requests[i].duration_in_days = durations[i];
+  }
+  return workload;
+}
+
+std::vector<int> PeoplePerGroup(soa1::rg::mm::GroupHandler& group_handler,
+    const Workload& workload, int n_requests) {
+  std::vector<int> n_people_per_group(group_handler.NumberOfGroups(), 0);
+  for (int i = 0; i < n_requests; ++i) {
+    ++n_people_per_group[group_handler.GroupNumber(workload.requests[i])];
+  }
+  return n_people_per_group;
+}
+
+void MatchMakingKernels(soa1::sv::State& state, const Workload& workload) {
+  int time = 0;
+  soa1::rg::mm::GroupHandler group_handler(time,
+      state.parameter_pack().matchmaking);
+
+  for (int n_requests : {1000, 10000, 100000}) {
+    if (n_requests > static_cast<int>(workload.requests.size())) break;
+    std::vector<int> n_people_per_group =
+        PeoplePerGroup(group_handler, workload, n_requests);
+    soa1::rg::mm::LinkHandler link_handler(
+        group_handler.PreferenceMatrix().Sparse());
+    Run("link_handler_cycle", std::to_string(n_requests), [&]() {
+      const int n_days = 20;
+      for (int day = 0; day < n_days; ++day) {
+        std::vector<int> r = n_people_per_group;
+        link_handler.SortByLinks();
+        link_handler.Add(r);
+        link_handler.SortByValue();
+        link_handler.PointToTop();
+        while (link_handler.PointsToPositiveLink()) {
+          alje::MultiSetSize2<int> link = link_handler.Get();
+          const int g1 = link.first;
+          const int g2 = link.second;
+          if ((g1 == g2 && r[g1] > 1) || (g1 != g2 && r[g1] > 0 && r[g2] > 0)) {
+            link_handler.Remove();
+            --r[g1];
+            --r[g2];
+          } else {
+            link_handler.Next();
+          }
+        }
+      }
+      return static_cast<long long>(n_days);
+    });
+  }
+
+  std::vector<int> n_people_per_group = PeoplePerGroup(group_handler,
+      workload, static_cast<int>(workload.requests.size()));
+  for (bool msm_hack : {true, false}) {
+    soa1::rg::mm::PartnerChoiceParameters pcm_par;
+    pcm_par.enable_msm_hack = msm_hack;
+    soa1::rg::mm::PartnerChoiceMatrix partner_choice_matrix(
+        group_handler.PreferenceMatrix(), pcm_par);
+    partner_choice_matrix.UpdateDatabase(n_people_per_group);
+    Run("partner_choice_matrix_get", msm_hack ? "msm_hack" : "no_msm_hack",
+        [&]() {
+      const int n_gets = 10;
+      for (int i = 0; i < n_gets; ++i) {
+        soa1::rg::mm::SparseGroupMatrix pcm = partner_choice_matrix.Get();
+        checksum += pcm.Value(0);
+      }
+      return static_cast<long long>(n_gets);
+    });
+  }
+}
+
+void GetDurationKernel(soa1::sv::State& state, const Workload& workload) {
+  const std::vector<int>& all = workload.interrelation_times;
+  for (int batch_size : {1, 1000, 100000}) {
+    Run("get_duration", std::to_string(batch_size), [&]() {
+      long long ops = 0;
+      for (int first = 0; first + batch_size <= static_cast<int>(all.size());
+          first += batch_size) {
+        std::vector<int> batch(all.begin() + first,
+            all.begin() + first + batch_size);
+        std::vector<int> durations = state.get_duration().Get(batch);
+        checksum += durations.back();
+        ops += batch_size;
+      }
+      return ops;
+    });
+  }
+}
+
+void NextRelationPersonTimeKernel(soa1::sv::State& state) {
+  const int n_persons = 200;
+  const int never = std::numeric_limits<int>::max();
+  Run("next_relation_person_time", "newborn_lifetime", [&]() {
+    long long ops = 0;
+    for (int i = 0; i < n_persons; ++i) {
+      soa1::sv::Person person(0, state.relation_start_model(),
+          state.seed_generator(), state.process_x_generator());
+      int t;
+      do {
+        t = person.next_relation_time();
+        ++ops;
+      } while (t != never);
+    }
+    return ops;
+  });
+  Run("next_relation_person_time", "age_50_to_now", [&]() {
+    long long ops = 0;
+    for (int i = 0; i < n_persons; ++i) {
+      soa1::sv::Person person(-50 * 365, state.relation_start_model(),
+          state.seed_generator(), state.process_x_generator());
+      int t;
+      do {
+        t = person.next_relation_time();
+        ++ops;
+      } while (t <= 0);
+    }
+    return ops;
+  });
+}
+
+void TransmissionKernels(soa1::sv::State& state) {
+  const soa1::parameters::ParameterPack& par = state.parameter_pack();
+  soa1::tr::Transmission transmission(par.sexual_behavior, par.hiv,
+      par.gonorrhea, state.Stream(soa1::sv::stream::TRANSMISSION));
+  soa1::tr::SexualBehaviorLayer sexual_behavior_layer(par.sexual_behavior);
+  soa1::tr::HIVLayer hiv_layer(par.hiv);
+  soa1::sv::Person infected(-30 * 365, state.relation_start_model(),
+      state.seed_generator(), state.process_x_generator());
+  soa1::sv::Person susceptible(-30 * 365, state.relation_start_model(),
+      state.seed_generator(), state.process_x_generator());
+  infected.hiv_status().infected() = true;
+
+  for (int days_infected : {0, 400, 5000}) {
+    infected.hiv_status().t_infected() = -days_infected;
+    soa1::sv::Relation relation(infected.id(), susceptible.id(), 0, 365);
+    const int n_calls = 100000;
+    Run("hiv_transmission", std::to_string(days_infected), [&]() {
+      for (int i = 0; i < n_calls; ++i) {
+        checksum += transmission.GetHIVTransmission(relation, infected,
+            susceptible, 0);
+      }
+      return static_cast<long long>(n_calls);
+    });
+    const soa1::tr::Layer& sb_layer =
+        sexual_behavior_layer.Get(relation, infected, susceptible, 0);
+    soa1::tr::Layer sti_layer = hiv_layer.Get(relation, infected, susceptible,
+        0);
+    Run("create_multiplication_layer", std::to_string(days_infected), [&]() {
+      for (int i = 0; i < n_calls; ++i) {
+        checksum += soa1::tr::CreateMultiplicationLayer(sb_layer, sti_layer)
+            .back().y;
+      }
+      return static_cast<long long>(n_calls);
+    });
+  }
+}
+
+void ListKernels(soa1::sv::State& state, const std::vector<int>& person_ids) {
+  for (int n_relations : {1000, 10000}) {
+    Run("relation_list", std::to_string(n_relations), [&]() {
+      soa1::sv::RelationList relation_list;
+      std::vector<int> relation_ids;
+      for (int i = 0; i < n_relations; ++i) {
+        soa1::sv::Relation relation(person_ids[2 * i], person_ids[2 * i + 1],
+            0, 100);
+        relation_ids.push_back(relation.relation_id());
+        relation_list.Insert(relation);
+      }
+      for (int i = 0; i < 2 * n_relations; ++i) {
+        checksum +=
+            relation_list.FindRelationIDsGivenPersonID(person_ids[i]).size();
+      }
+      for (int id : relation_ids) relation_list.RemoveGivenRelationID(id);
+      return static_cast<long long>(n_relations);
+    });
+  }
+
+  std::vector<int> shuffled_ids = person_ids;
+  soa1::sv::CounterRng rng(kSeed, 2);
+  std::shuffle(shuffled_ids.begin(), shuffled_ids.end(), rng);
+  for (bool random_order : {false, true}) {
+    const std::vector<int>& ids = random_order ? shuffled_ids : person_ids;
+    Run("person_list_lookup", random_order ? "random" : "in_order", [&]() {
+      for (int id : ids) checksum += state.person_list()[id].day_of_birth();
+      return static_cast<long long>(ids.size());
+    });
+  }
+}
+} // !namespace
+
+int main(int argc, char* argv[]) {
+  if (argc > 1) kernel_filter = argv[1];
+
+  soa1::sv::State state(kSeed);
+  std::vector<int> person_ids = soa1::dem::Populate(state);
+  Workload workload = CaptureWorkload(state, person_ids);
+
+  std::cout << "kernel,case,ops_per_repetition,repetitions,ns_per_op_min,"
+    "ns_per_op_median\n";
+  MatchMakingKernels(state, workload);
+  GetDurationKernel(state, workload);
+  NextRelationPersonTimeKernel(state);
+  TransmissionKernels(state);
+  ListKernels(state, person_ids);
+  std::cerr << "checksum: " << checksum << "\n";
+  return 0;
+}
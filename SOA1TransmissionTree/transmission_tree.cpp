@@ -0,0 +1,199 @@
+/* SOA1, individual based STI simulation
+Copyright (C) 2015, RIVM
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.*/
+
+/*
+GOAL: Read a transmission tree written by a simulation (see
+sv::TransmissionTreeLog) and extract what is needed for phylodynamic analysis
+without loading it into other tools first.
+
+INPUT: (command line) SOA1TransmissionTree file command [arguments]
+  summary: number of records per disease and the first and last day.
+  clusters disease: the size distribution of the clusters (trees).
+  subtree disease person_id: every transmission descending from the person.
+  disease: hiv or gn.
+
+IMPLEMENTATION: The file is read in one go. Every record (an infection) gets
+as parent the last infection of its infector with the same disease, which is
+always an earlier record as the file is in order of time. The roots are the
+initially infected (and infections of which the infector was not recorded).
+Cluster sizes are added up from the last record to the first (children
+before parents), subtrees are found with a depth first search over the
+children. Everything is linear in the number of records.
+
+OUTPUT: Tab separated text on std::cout.
+  summary: disease, records, first_day, last_day
+  clusters: size, n_clusters
+  subtree: day, infector_id, infectee_id, relation_id, infector_stage, flags
+*/
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <map>
+#include <string>
+#include <cstdlib>
+#include <unordered_map>
+#include <algorithm> // For sort
+
+#include "soa1_sv_transmission_tree_log.h"
+
+namespace {
+namespace transmission_tree = soa1::sv::transmission_tree;
+typedef transmission_tree::Record Record;
+
+std::vector<Record> Load(const std::string& file_name) {
+  std::ifstream file(file_name, std::ios::binary | std::ios::ate);
+  if (file.is_open() == false) {
+    std::cerr << "Could not open " << file_name << "\n";
+    std::exit(1);
+  }
+  std::streamoff size = file.tellg();
+  if (size % sizeof(Record) != 0) {
+    std::cerr << file_name << " is not a transmission tree (size)\n";
+    std::exit(1);
+  }
+  std::vector<Record> records(static_cast<std::size_t>(size / sizeof(Record)));
+  file.seekg(0);
+  file.read(reinterpret_cast<char*>(records.data()), size);
+  return records;
+}
+
+int DiseaseGivenName(const std::string& name) {
+  for (int disease = 0; disease < transmission_tree::N_DISEASES; ++disease) {
+    if (name == transmission_tree::DiseaseName(disease)) return disease;
+  }
+  std::cerr << "Unknown disease " << name << " (use hiv or gn)\n";
+  std::exit(1);
+}
+
+// The records of one disease with the parent of every record (index in the
+// same vector, -1 for roots).
+struct Tree {
+  std::vector<Record> records;
+  std::vector<int> parent;
+};
+
+Tree BuildTree(const std::vector<Record>& all_records, int disease) {
+  Tree tree;
+  std::unordered_map<int, int> last_infection; // person id -> record index
+  for (const Record& record : all_records) {
+    if (record.disease != disease) continue;
+    int index = static_cast<int>(tree.records.size());
+    auto infector = last_infection.find(record.infector_id);
+    tree.parent.push_back(
+        infector == last_infection.end() ? -1 : infector->second);
+    tree.records.push_back(record);
+    last_infection[record.infectee_id] = index; // Gonorrhea can reinfect.
+  }
+  return tree;
+}
+
+void Summary(const std::vector<Record>& records) {
+  std::map<int, std::vector<int>> n_first_last; // disease -> n, first, last
+  for (const Record& record : records) {
+    std::vector<int>& v = n_first_last[record.disease];
+    if (v.empty()) v = {0, record.day, record.day};
+    ++v[0];
+    v[2] = record.day; // In order of time.
+  }
+  std::cout << "disease\trecords\tfirst_day\tlast_day\n";
+  for (const auto& disease_v : n_first_last) {
+    std::cout << transmission_tree::DiseaseName(disease_v.first) << "\t"
+      << disease_v.second[0] << "\t" << disease_v.second[1] << "\t"
+      << disease_v.second[2] << "\n";
+  }
+}
+
+void Clusters(const Tree& tree) {
+  std::vector<long long> size(tree.records.size(), 1);
+  std::map<long long, long long> n_clusters_given_size;
+  for (int i = static_cast<int>(tree.records.size()) - 1; i >= 0; --i) {
+    if (tree.parent[i] == -1) {
+      ++n_clusters_given_size[size[i]];
+    } else {
+      size[tree.parent[i]] += size[i];
+    }
+  }
+  std::cout << "size\tn_clusters\n";
+  for (const auto& size_n : n_clusters_given_size) {
+    std::cout << size_n.first << "\t" << size_n.second << "\n";
+  }
+}
+
+void Subtree(const Tree& tree, int person_id) {
+  // The children of every record (compressed: children of i are in
+  // children[first_child[i]] up to children[first_child[i + 1]]).
+  int n = static_cast<int>(tree.records.size());
+  std::vector<int> first_child(n + 1, 0);
+  for (int i = 0; i < n; ++i) {
+    if (tree.parent[i] != -1) ++first_child[tree.parent[i] + 1];
+  }
+  for (int i = 0; i < n; ++i) first_child[i + 1] += first_child[i];
+  std::vector<int> children(first_child[n]);
+  std::vector<int> next = first_child;
+  for (int i = 0; i < n; ++i) {
+    if (tree.parent[i] != -1) children[next[tree.parent[i]]++] = i;
+  }
+
+  // Start from every infection of the person.
+  std::vector<int> stack;
+  for (int i = 0; i < n; ++i) {
+    if (tree.records[i].infectee_id == person_id) stack.push_back(i);
+  }
+  std::vector<int> subtree;
+  while (stack.empty() == false) {
+    int i = stack.back();
+    stack.pop_back();
+    for (int c = first_child[i]; c < first_child[i + 1]; ++c) {
+      subtree.push_back(children[c]);
+      stack.push_back(children[c]);
+    }
+  }
+  std::sort(subtree.begin(), subtree.end()); // Back in order of time.
+
+  std::cout << "day\tinfector_id\tinfectee_id\trelation_id\tinfector_stage\t"
+    "flags\n";
+  for (int i : subtree) {
+    const Record& r = tree.records[i];
+    std::cout << r.day << "\t" << r.infector_id << "\t" << r.infectee_id 
+      << "\t" << r.relation_id << "\t" << static_cast<int>(r.infector_stage)
+      << "\t" << static_cast<int>(r.flags) << "\n";
+  }
+}
+
+void Usage() {
+  std::cerr << "SOA1TransmissionTree file summary\n"
+    "SOA1TransmissionTree file clusters hiv|gn\n"
+    "SOA1TransmissionTree file subtree hiv|gn person_id\n";
+  std::exit(1);
+}
+} // !namespace
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) Usage();
+  std::vector<Record> records = Load(argv[1]);
+  std::string command = argv[2];
+
+  if (command == "summary") {
+    Summary(records);
+  } else if (command == "clusters" && argc == 4) {
+    Clusters(BuildTree(records, DiseaseGivenName(argv[3])));
+  } else if (command == "subtree" && argc == 5) {
+    Subtree(BuildTree(records, DiseaseGivenName(argv[3])), std::atoi(argv[4]));
+  } else {
+    Usage();
+  }
+  return 0;
+}